@@ -0,0 +1,43 @@
+"use strict";
+
+/**
+ * Per-call time of the asynchronous entries, which take the GIL on worker threads. A batch of a
+ * single call queues one work item on the libuv pool per call, so it measures the acquisition of
+ * a thread state on the pool threads more than the call itself.
+ *
+ * Run it against the build before and after the change to compare:
+ *
+ *     node bench/async_call.js
+ *     NPI_ADDON=../baseline/build/Release/NodePython.node node bench/async_call.js
+ */
+
+const { load, measureAsync, report } = require("./common");
+
+const ITERATIONS  = Number(process.env.ITERATIONS || 20000);
+const CONCURRENCY = Number(process.env.CONCURRENCY || 4);
+
+async function main()
+{
+    const npi = load();
+    const abs = npi.getattr(npi.import("builtins"), "abs");
+
+    if (npi.resetStats) { npi.resetStats(); }
+
+    report("callManyAsync(abs, [[-1]])", await measureAsync(() => npi.callManyAsync(abs, [[-1]]), ITERATIONS, CONCURRENCY));
+    report("callAsync(abs, -1)", await measureAsync(() => npi.callAsync(abs, -1), ITERATIONS, CONCURRENCY));
+
+    if (npi.stats)
+    {
+        const stats = npi.stats();
+
+        console.log();
+        console.log("Thread states:", stats.threadStates);
+        console.log("GIL wait of async:", stats.gil.async.wait);
+    }
+}
+
+main().catch((error) =>
+{
+    console.error(error);
+    process.exitCode = 1;
+});
@@ -0,0 +1,67 @@
+"use strict";
+
+const path = require("path");
+
+/**
+ * Load the addon, from `NPI_ADDON` when set so that two builds can be compared, and start the
+ * interpreter. `NPI_LIBPYTHON` names the shared library to load first when it is not linked.
+ */
+function load()
+{
+    const npi = process.env.NPI_ADDON
+        ? require(path.resolve(process.env.NPI_ADDON))
+        : require("bindings")("NodePython");
+
+    if (process.env.NPI_LIBPYTHON)
+    {
+        npi.dlOpen(process.env.NPI_LIBPYTHON);
+    }
+
+    npi.startInterpreter();
+
+    return npi;
+}
+
+/**
+ * Run `fn` `iterations` times after a warm-up, and return the mean time of a call in nanoseconds.
+ */
+function measure(fn, iterations)
+{
+    for (let i = 0; i < Math.min(iterations, 10000); i++) { fn(); }
+
+    const start = process.hrtime.bigint();
+    for (let i = 0; i < iterations; i++) { fn(); }
+
+    return Number(process.hrtime.bigint() - start) / iterations;
+}
+
+/**
+ * Like `measure`, for a function returning a promise, with up to `concurrency` calls in flight.
+ */
+async function measureAsync(fn, iterations, concurrency)
+{
+    const run = async (count) =>
+    {
+        let next = 0;
+        const worker = async () => { while (next++ < count) { await fn(); } };
+
+        await Promise.all(Array.from({ length: concurrency }, worker));
+    };
+
+    await run(Math.min(iterations, 1000));
+
+    const start = process.hrtime.bigint();
+    await run(iterations);
+
+    return Number(process.hrtime.bigint() - start) / iterations;
+}
+
+/**
+ * Print a row of the results.
+ */
+function report(name, ns_per_call)
+{
+    console.log(`${name.padEnd(28)} ${ns_per_call.toFixed(0).padStart(10)} ns/call`);
+}
+
+module.exports = { load, measure, measureAsync, report };
@@ -0,0 +1,36 @@
+"use strict";
+
+/**
+ * Per-call time of the synchronous entries on the main thread, which restore the main thread
+ * state directly instead of going through `PyGILState_Ensure`.
+ *
+ * Run it against the build before and after the change to compare:
+ *
+ *     node bench/sync_entry.js
+ *     NPI_ADDON=../baseline/build/Release/NodePython.node node bench/sync_entry.js
+ */
+
+const { load, measure, report } = require("./common");
+
+const ITERATIONS = Number(process.env.ITERATIONS || 200000);
+
+const npi  = load();
+const math = npi.import("math");
+
+if (npi.resetStats) { npi.resetStats(); }
+
+report("getattr(math, \"pi\")", measure(() => npi.getattr(math, "pi"), ITERATIONS));
+report("eval(\"1 + 1\")", measure(() => npi.eval("1 + 1"), ITERATIONS));
+
+if (npi.stats)
+{
+    const stats = npi.stats();
+
+    console.log();
+    console.log("Thread state entries:", stats.threadStates);
+
+    for (const entry of ["getattr", "eval"])
+    {
+        if (stats.gil[entry]) { console.log(`GIL wait of ${entry}:`, stats.gil[entry].wait); }
+    }
+}
@@ -5,10 +5,28 @@
             "sources": [
                 "src/main.cpp",
                 "src/npi.cpp",
+                "src/arrow.cpp",
+                "src/batch_call.cpp",
+                "src/chain.cpp",
+                "src/columnar.cpp",
+                "src/conversion_plan.cpp",
+                "src/cycle_collector.cpp",
+                "src/executor.cpp",
+                "src/external_memory.cpp",
+                "src/gil.cpp",
+                "src/handle_table.cpp",
+                "src/histogram.cpp",
+                "src/instance_data.cpp",
                 "src/interop_helpers.cpp",
+                "src/key_cache.cpp",
+                "src/node_callback.cpp",
                 "src/node_wrapper.c",
                 "src/python_wrapper.cpp",
+                "src/release_queue.cpp",
+                "src/thread_state.cpp",
+                "src/trampoline.cpp",
                 "src/type_helpers.cpp",
+                "src/watchdog.cpp",
             ],
             "include_dirs": [
                 "<!@(echo $NVM_INC)",
@@ -1,5 +1,10 @@
+import sys
 import sysconfig
 
+# The bridge calls through the vectorcall protocol, which appeared in Python 3.8.
+if sys.version_info < (3, 8):
+    raise RuntimeError("Python 3.8 or later is required, found " + sys.version.split()[0] + ".")
+
 flags = []
 
 includes = [
@@ -0,0 +1,860 @@
+#include "arrow.hpp"
+#include "interop_helpers.hpp"
+#include "python_helpers.hpp"
+#include "release_queue.hpp"
+#include "type_helpers.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray
+{
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream
+{
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+
+    void (*release)(struct ArrowArrayStream*);
+    void* private_data;
+};
+
+#endif
+
+namespace
+{
+    /**
+     * The width in bytes of the values of a fixed-width format, or 0 for any other format.
+     */
+    size_t FixedWidth(const std::string& format)
+    {
+        if (format.size() == 1)
+        {
+            switch (format[0])
+            {
+                case 'c': case 'C':           return 1;
+                case 's': case 'S': case 'e': return 2;
+                case 'i': case 'I': case 'f': return 4;
+                case 'l': case 'L': case 'g': return 8;
+            }
+        }
+
+        if ((format == "tdD") || (format == "tts") || (format == "ttm") || (format == "tiM")) { return 4; }
+        if ((format == "tdm") || (format == "ttu") || (format == "ttn") || (format == "tiD")) { return 8; }
+        if (format == "tin") { return 16; }
+
+        if ((format.compare(0, 2, "ts") == 0) || (format.compare(0, 2, "tD") == 0)) { return 8; }
+
+        if (format.compare(0, 2, "w:") == 0)
+        {
+            return std::strtoull(format.c_str() + 2, nullptr, 10);
+        }
+
+        if (format.compare(0, 2, "d:") == 0)
+        {
+            // "d:precision,scale[,bitwidth]", 128 bits unless given.
+            auto first = format.find(',');
+            auto last  = format.rfind(',');
+
+            return ((first != last) ? std::strtoull(format.c_str() + last + 1, nullptr, 10) : 128) / 8;
+        }
+
+        return 0;
+    }
+
+    /**
+     * The sizes in bytes of the buffers of an array, as required by its format.
+     *
+     * @param available When not null, the sizes of the buffers, checked against the required sizes
+     *                  before any offset is read from them.
+     */
+    std::vector<size_t> BufferSizes(const Napi::Env& env, const char* format, int64_t offset, int64_t length, int64_t n_buffers, const void* const* buffers, const size_t* available)
+    {
+        if ((offset < 0) || (length < 0))
+        {
+            throw Napi::RangeError::New(env, "The offset and length of an Arrow array must not be negative.");
+        }
+
+        std::string kind(format);
+
+        auto end    = static_cast<size_t>(offset + length);
+        auto bitmap = (end + 7) / 8;
+
+        std::vector<size_t> sizes;
+        size_t offset_width = 0;
+
+        if (kind == "n")
+        {
+        }
+        else if (kind == "b")
+        {
+            sizes = { bitmap, bitmap };
+        }
+        else if (auto width = FixedWidth(kind))
+        {
+            sizes = { bitmap, end * width };
+        }
+        else if ((kind == "u") || (kind == "z") || (kind == "U") || (kind == "Z"))
+        {
+            offset_width = ((kind == "U") || (kind == "Z")) ? 8 : 4;
+            sizes = { bitmap, (end + 1) * offset_width, 0 };
+        }
+        else if ((kind == "+l") || (kind == "+m"))
+        {
+            sizes = { bitmap, (end + 1) * 4 };
+        }
+        else if (kind == "+L")
+        {
+            sizes = { bitmap, (end + 1) * 8 };
+        }
+        else if ((kind == "+s") || (kind.compare(0, 3, "+w:") == 0))
+        {
+            sizes = { bitmap };
+        }
+        else
+        {
+            throw Napi::TypeError::New(env, "Unsupported Arrow format: " + kind);
+        }
+
+        if (static_cast<size_t>(n_buffers) != sizes.size())
+        {
+            throw Napi::TypeError::New(env, "An Arrow array of format " + kind + " must have " + std::to_string(sizes.size()) + " buffers.");
+        }
+
+        for (size_t i = 0; i < sizes.size(); i++)
+        {
+            if (offset_width && (i == 2) && (buffers[1] != nullptr))
+            {
+                // The values of a string array end at its last offset.
+                auto last = (offset_width == 8)
+                    ? static_cast<const int64_t*>(buffers[1])[end]
+                    : static_cast<const int32_t*>(buffers[1])[end];
+
+                if (last < 0)
+                {
+                    throw Napi::RangeError::New(env, "An Arrow array has a negative offset.");
+                }
+
+                sizes[2] = static_cast<size_t>(last);
+            }
+
+            if ((available != nullptr) && (sizes[i] > available[i]) && ((buffers[i] != nullptr) || (i != 0)))
+            {
+                throw Napi::RangeError::New(env, "Buffer " + std::to_string(i) + " of an Arrow array of format " + kind + " is too small.");
+            }
+        }
+
+        return sizes;
+    }
+
+    void ReleaseArrayCapsule(PyObject* p_capsule)
+    {
+        auto array = static_cast<ArrowArray*>(PyCapsule_GetPointer(p_capsule, "arrow_array"));
+        if (array->release != nullptr) { array->release(array); }
+
+        delete array;
+    }
+
+    void ReleaseSchemaCapsule(PyObject* p_capsule)
+    {
+        auto schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(p_capsule, "arrow_schema"));
+        if (schema->release != nullptr) { schema->release(schema); }
+
+        delete schema;
+    }
+
+    Napi::Value ToNodeMetadata(const Napi::Env& env, const char* metadata)
+    {
+        if (metadata == nullptr)
+        {
+            return env.Null();
+        }
+
+        auto n_metadata = Napi::Object::New(env);
+
+        auto read = [&metadata]()
+        {
+            int32_t value;
+            std::memcpy(&value, metadata, sizeof(value));
+            metadata += sizeof(value);
+
+            return value;
+        };
+
+        auto pairs = read();
+        for (int32_t i = 0; i < pairs; i++)
+        {
+            auto key_length = read();
+            std::string key(metadata, key_length);
+            metadata += key_length;
+
+            auto value_length = read();
+            n_metadata.Set(key, Napi::String::New(env, metadata, value_length));
+            metadata += value_length;
+        }
+
+        return n_metadata;
+    }
+
+    /**
+     * Describe the type of a field, and of its children when `nested` is set.
+     */
+    Napi::Object DescribeSchema(const Napi::Env& env, const ArrowSchema* schema, bool nested)
+    {
+        auto n_schema = Napi::Object::New(env);
+
+        n_schema.Set("format", Napi::String::New(env, schema->format));
+        n_schema.Set("name", Napi::String::New(env, (schema->name != nullptr) ? schema->name : ""));
+        n_schema.Set("nullable", Napi::Boolean::New(env, (schema->flags & ARROW_FLAG_NULLABLE) != 0));
+        n_schema.Set("metadata", ToNodeMetadata(env, schema->metadata));
+
+        if (schema->dictionary != nullptr)
+        {
+            n_schema.Set("dictionaryOrdered", Napi::Boolean::New(env, (schema->flags & ARROW_FLAG_DICTIONARY_ORDERED) != 0));
+        }
+
+        if (nested)
+        {
+            auto n_children = Napi::Array::New(env, schema->n_children);
+            for (int64_t i = 0; i < schema->n_children; i++)
+            {
+                n_children.Set(static_cast<uint32_t>(i), DescribeSchema(env, schema->children[i], true));
+            }
+
+            n_schema.Set("children", n_children);
+            n_schema.Set("dictionary", (schema->dictionary != nullptr) ? DescribeSchema(env, schema->dictionary, true) : env.Null());
+        }
+
+        return n_schema;
+    }
+
+    Napi::Object DescribeArray(const Napi::Env& env, const ArrowSchema* schema, const ArrowArray* array, PyObject* p_owner)
+    {
+        if ((schema->n_children != array->n_children) || ((schema->dictionary == nullptr) != (array->dictionary == nullptr)))
+        {
+            throw Napi::TypeError::New(env, "An Arrow array does not match its schema.");
+        }
+
+        auto n_array = DescribeSchema(env, schema, false);
+
+        n_array.Set("length", Napi::Number::New(env, static_cast<double>(array->length)));
+        n_array.Set("nullCount", Napi::Number::New(env, static_cast<double>(array->null_count)));
+        n_array.Set("offset", Napi::Number::New(env, static_cast<double>(array->offset)));
+
+        auto sizes = BufferSizes(env, schema->format, array->offset, array->length, array->n_buffers, array->buffers, nullptr);
+
+        auto n_buffers = Napi::Array::New(env, sizes.size());
+        for (size_t i = 0; i < sizes.size(); i++)
+        {
+            n_buffers.Set(static_cast<uint32_t>(i), (array->buffers[i] != nullptr) ? NPI::ToNodeSharedBuffer(env, array->buffers[i], sizes[i], p_owner, true) : env.Null());
+        }
+
+        n_array.Set("buffers", n_buffers);
+
+        auto n_children = Napi::Array::New(env, array->n_children);
+        for (int64_t i = 0; i < array->n_children; i++)
+        {
+            n_children.Set(static_cast<uint32_t>(i), DescribeArray(env, schema->children[i], array->children[i], p_owner));
+        }
+
+        n_array.Set("children", n_children);
+        n_array.Set("dictionary", (array->dictionary != nullptr) ? DescribeArray(env, schema->dictionary, array->dictionary, p_owner) : env.Null());
+
+        return n_array;
+    }
+
+    [[noreturn]] void ThrowStreamError(const Napi::Env& env, ArrowArrayStream* stream, int status)
+    {
+        auto message = (stream->get_last_error != nullptr) ? stream->get_last_error(stream) : nullptr;
+
+        throw Napi::Error::New(env, (message != nullptr) ? std::string(message) : "An Arrow stream failed with error " + std::to_string(status) + ".");
+    }
+
+    /**
+     * The Node buffers pinned by an exported array, released once every ArrowArray and ArrowSchema
+     * made from them is released.
+     */
+    struct ExportRoot;
+
+    struct ExportNode
+    {
+        std::string format;
+        std::string name;
+        std::string metadata;
+
+        int64_t flags      = 0;
+        int64_t length     = 0;
+        int64_t null_count = -1;
+        int64_t offset     = 0;
+
+        std::vector<const void*> buffers;
+
+        std::vector<ExportNode> children;
+
+        std::unique_ptr<ExportNode> dictionary;
+    };
+
+    struct ExportRoot
+    {
+        napi_env env;
+
+        std::vector<napi_ref> references;
+
+        ExportNode node;
+
+        ~ExportRoot()
+        {
+            // The consumer may release the array on any thread.
+            for (auto reference : references) { NPI::ScheduleUnref(env, reference); }
+        }
+    };
+
+    std::string ToArrowMetadata(const Napi::Value& n_metadata)
+    {
+        if (n_metadata.IsUndefined() || n_metadata.IsNull()) { return std::string(); }
+
+        auto n_object = n_metadata.As<Napi::Object>();
+        auto n_keys   = n_object.GetPropertyNames();
+
+        std::string metadata;
+        auto write = [&metadata](const std::string& value, bool sized)
+        {
+            if (sized)
+            {
+                auto length = static_cast<int32_t>(value.size());
+                metadata.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            }
+
+            metadata.append(value);
+        };
+
+        auto pairs = static_cast<int32_t>(n_keys.Length());
+        metadata.append(reinterpret_cast<const char*>(&pairs), sizeof(pairs));
+
+        for (uint32_t i = 0; i < n_keys.Length(); i++)
+        {
+            auto n_key = n_keys.Get(i);
+
+            write(n_key.ToString().Utf8Value(), true);
+            write(n_object.Get(n_key).ToString().Utf8Value(), true);
+        }
+
+        return metadata;
+    }
+
+    void ParseExportNode(const Napi::Env& env, const Napi::Value& n_value, ExportNode& node, ExportRoot& root)
+    {
+        if (!n_value.IsObject())
+        {
+            throw Napi::TypeError::New(env, "An Arrow array must be described by an object.");
+        }
+
+        auto n_array = n_value.As<Napi::Object>();
+
+        node.format   = n_array.Get("format").As<Napi::String>().Utf8Value();
+        node.name     = n_array.Has("name") ? n_array.Get("name").ToString().Utf8Value() : std::string();
+        node.metadata = ToArrowMetadata(n_array.Get("metadata"));
+        node.length   = n_array.Get("length").As<Napi::Number>().Int64Value();
+
+        auto n_null_count = n_array.Get("nullCount");
+        auto n_offset     = n_array.Get("offset");
+        auto n_nullable   = n_array.Get("nullable");
+
+        node.null_count = n_null_count.IsNumber() ? n_null_count.As<Napi::Number>().Int64Value() : -1;
+        node.offset     = n_offset.IsNumber() ? n_offset.As<Napi::Number>().Int64Value() : 0;
+
+        if (n_nullable.IsUndefined() || n_nullable.ToBoolean())
+        {
+            node.flags |= ARROW_FLAG_NULLABLE;
+        }
+
+        if (n_array.Get("dictionaryOrdered").ToBoolean())
+        {
+            node.flags |= ARROW_FLAG_DICTIONARY_ORDERED;
+        }
+
+        auto n_buffers = n_array.Get("buffers");
+        if (!n_buffers.IsArray())
+        {
+            throw Napi::TypeError::New(env, "The buffers of an Arrow array must be an array.");
+        }
+
+        std::vector<size_t> available;
+
+        auto n_buffer_list = n_buffers.As<Napi::Array>();
+        for (uint32_t i = 0; i < n_buffer_list.Length(); i++)
+        {
+            auto n_buffer = n_buffer_list.Get(i);
+
+            const void* data = nullptr;
+            size_t      size = 0;
+
+            if (n_buffer.IsArrayBuffer())
+            {
+                auto n_array_buffer = n_buffer.As<Napi::ArrayBuffer>();
+
+                data = n_array_buffer.Data();
+                size = n_array_buffer.ByteLength();
+            }
+            else if (n_buffer.IsTypedArray() || n_buffer.IsDataView())
+            {
+                napi_value n_array_buffer;
+                size_t     byte_offset;
+                napi_status status;
+
+                if (n_buffer.IsTypedArray())
+                {
+                    size = n_buffer.As<Napi::TypedArray>().ByteLength();
+                    status = napi_get_typedarray_info(env, n_buffer, nullptr, nullptr, nullptr, &n_array_buffer, &byte_offset);
+                }
+                else
+                {
+                    status = napi_get_dataview_info(env, n_buffer, &size, nullptr, &n_array_buffer, &byte_offset);
+                }
+
+                if (status != napi_ok)
+                {
+                    throw Napi::Error::New(env);
+                }
+
+                data = static_cast<const uint8_t*>(Napi::ArrayBuffer(env, n_array_buffer).Data()) + byte_offset;
+            }
+            else if (!NPI::IsNullLike(n_buffer))
+            {
+                throw Napi::TypeError::New(env, "The buffers of an Arrow array must be ArrayBuffers, views or null.");
+            }
+
+            if (data != nullptr)
+            {
+                napi_ref reference;
+                if (napi_create_reference(env, n_buffer, 1, &reference) != napi_ok)
+                {
+                    throw Napi::Error::New(env);
+                }
+
+                root.references.push_back(reference);
+            }
+
+            node.buffers.push_back(data);
+            available.push_back(size);
+        }
+
+        BufferSizes(env, node.format.c_str(), node.offset, node.length, node.buffers.size(), node.buffers.data(), available.data());
+
+        auto n_children = n_array.Get("children");
+        if (n_children.IsArray())
+        {
+            auto n_child_list = n_children.As<Napi::Array>();
+
+            node.children.resize(n_child_list.Length());
+            for (uint32_t i = 0; i < n_child_list.Length(); i++)
+            {
+                ParseExportNode(env, n_child_list.Get(i), node.children[i], root);
+            }
+        }
+
+        auto n_dictionary = n_array.Get("dictionary");
+        if (!NPI::IsNullLike(n_dictionary))
+        {
+            node.dictionary = std::unique_ptr<ExportNode>(new ExportNode());
+            ParseExportNode(env, n_dictionary, *node.dictionary, root);
+        }
+    }
+
+    struct ExportSchemaData
+    {
+        std::shared_ptr<ExportRoot> root;
+
+        std::vector<ArrowSchema*> children;
+    };
+
+    struct ExportArrayData
+    {
+        std::shared_ptr<ExportRoot> root;
+
+        std::vector<const void*> buffers;
+
+        std::vector<ArrowArray*> children;
+    };
+
+    void ReleaseExportSchema(ArrowSchema* schema)
+    {
+        auto data = static_cast<ExportSchemaData*>(schema->private_data);
+
+        for (auto child : data->children)
+        {
+            if (child->release != nullptr) { child->release(child); }
+            delete child;
+        }
+
+        if (schema->dictionary != nullptr)
+        {
+            if (schema->dictionary->release != nullptr) { schema->dictionary->release(schema->dictionary); }
+            delete schema->dictionary;
+        }
+
+        delete data;
+        schema->release = nullptr;
+    }
+
+    void ReleaseExportArray(ArrowArray* array)
+    {
+        auto data = static_cast<ExportArrayData*>(array->private_data);
+
+        for (auto child : data->children)
+        {
+            if (child->release != nullptr) { child->release(child); }
+            delete child;
+        }
+
+        if (array->dictionary != nullptr)
+        {
+            if (array->dictionary->release != nullptr) { array->dictionary->release(array->dictionary); }
+            delete array->dictionary;
+        }
+
+        delete data;
+        array->release = nullptr;
+    }
+
+    void ExportSchema(ArrowSchema* schema, const ExportNode& node, const std::shared_ptr<ExportRoot>& root)
+    {
+        auto data = new ExportSchemaData { root, {} };
+
+        for (auto& child : node.children)
+        {
+            data->children.push_back(new ArrowSchema());
+            ExportSchema(data->children.back(), child, root);
+        }
+
+        schema->format       = node.format.c_str();
+        schema->name         = node.name.c_str();
+        schema->metadata     = node.metadata.empty() ? nullptr : node.metadata.data();
+        schema->flags        = node.flags;
+        schema->n_children   = static_cast<int64_t>(data->children.size());
+        schema->children     = data->children.data();
+        schema->dictionary   = nullptr;
+        schema->release      = ReleaseExportSchema;
+        schema->private_data = data;
+
+        if (node.dictionary)
+        {
+            schema->dictionary = new ArrowSchema();
+            ExportSchema(schema->dictionary, *node.dictionary, root);
+        }
+    }
+
+    void ExportArray(ArrowArray* array, const ExportNode& node, const std::shared_ptr<ExportRoot>& root)
+    {
+        auto data = new ExportArrayData { root, node.buffers, {} };
+
+        for (auto& child : node.children)
+        {
+            data->children.push_back(new ArrowArray());
+            ExportArray(data->children.back(), child, root);
+        }
+
+        array->length       = node.length;
+        array->null_count   = node.null_count;
+        array->offset       = node.offset;
+        array->n_buffers    = static_cast<int64_t>(data->buffers.size());
+        array->n_children   = static_cast<int64_t>(data->children.size());
+        array->buffers      = data->buffers.data();
+        array->children     = data->children.data();
+        array->dictionary   = nullptr;
+        array->release      = ReleaseExportArray;
+        array->private_data = data;
+
+        if (node.dictionary)
+        {
+            array->dictionary = new ArrowArray();
+            ExportArray(array->dictionary, *node.dictionary, root);
+        }
+    }
+
+    /**
+     * The Python side of an exported array. Every call to `__arrow_c_array__` makes a fresh pair of
+     * capsules over the same Node buffers.
+     */
+    struct ArrowExportObject
+    {
+        PyObject_HEAD
+
+        std::shared_ptr<ExportRoot>* root;
+    };
+
+    PyObject* NewSchemaCapsule(const std::shared_ptr<ExportRoot>& root)
+    {
+        auto schema = new ArrowSchema();
+        ExportSchema(schema, root->node, root);
+
+        auto p_schema = PyCapsule_New(schema, "arrow_schema", ReleaseSchemaCapsule);
+        if (p_schema == NULL)
+        {
+            schema->release(schema);
+            delete schema;
+        }
+
+        return p_schema;
+    }
+
+    PyObject* ArrowExport_ArrowCSchema(PyObject* self, PyObject*)
+    {
+        return NewSchemaCapsule(*reinterpret_cast<ArrowExportObject*>(self)->root);
+    }
+
+    PyObject* ArrowExport_ArrowCArray(PyObject* self, PyObject* args, PyObject* kwargs)
+    {
+        static const char* keywords[] = { "requested_schema", NULL };
+
+        // Casting to a requested schema is optional in the protocol, the array is exported as is.
+        PyObject* p_requested_schema = Py_None;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", const_cast<char**>(keywords), &p_requested_schema))
+        {
+            return NULL;
+        }
+
+        auto& root = *reinterpret_cast<ArrowExportObject*>(self)->root;
+
+        auto p_schema = NewSchemaCapsule(root);
+        if (p_schema == NULL)
+        {
+            return NULL;
+        }
+
+        auto array = new ArrowArray();
+        ExportArray(array, root->node, root);
+
+        auto p_array = PyCapsule_New(array, "arrow_array", ReleaseArrayCapsule);
+        if (p_array == NULL)
+        {
+            array->release(array);
+            delete array;
+            Py_DECREF(p_schema);
+
+            return NULL;
+        }
+
+        return Py_BuildValue("(NN)", p_schema, p_array);
+    }
+
+    void ArrowExport_Dealloc(PyObject* self)
+    {
+        auto type = Py_TYPE(self);
+
+        delete reinterpret_cast<ArrowExportObject*>(self)->root;
+        type->tp_free(self);
+
+        Py_DECREF(type);
+    }
+
+    PyTypeObject* GetArrowExportType()
+    {
+        static PyObject* p_type = NULL;
+
+        if (p_type == NULL)
+        {
+            static PyMethodDef methods[] =
+            {
+                { "__arrow_c_array__", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(ArrowExport_ArrowCArray)), METH_VARARGS | METH_KEYWORDS, NULL },
+                { "__arrow_c_schema__", ArrowExport_ArrowCSchema, METH_NOARGS, NULL },
+                { NULL, NULL, 0, NULL },
+            };
+
+            static PyType_Slot slots[] =
+            {
+                { Py_tp_dealloc, reinterpret_cast<void*>(ArrowExport_Dealloc) },
+                { Py_tp_methods, methods },
+                { 0, NULL },
+            };
+
+            static PyType_Spec spec = { "npi.ArrowArray", sizeof(ArrowExportObject), 0, Py_TPFLAGS_DEFAULT, slots };
+
+            p_type = PyType_FromSpec(&spec);
+        }
+
+        return reinterpret_cast<PyTypeObject*>(p_type);
+    }
+}
+
+bool NPI::IsArrowExportable(PyObject* p_object)
+{
+    static auto p_array_name  = PyUnicode_InternFromString("__arrow_c_array__");
+    static auto p_stream_name = PyUnicode_InternFromString("__arrow_c_stream__");
+
+    if (PyType_Check(p_object))
+    {
+        return false;
+    }
+
+    return (_PyType_Lookup(Py_TYPE(p_object), p_array_name) != NULL) || (_PyType_Lookup(Py_TYPE(p_object), p_stream_name) != NULL);
+}
+
+Napi::Value NPI::ToNodeArrow(const Napi::Env& env, PyObject* p_object)
+{
+    PythonReferences python_refs;
+
+    if (PyObject_HasAttrString(p_object, "__arrow_c_array__"))
+    {
+        auto p_capsules = python_refs.Push(PyObject_CallMethod(p_object, "__arrow_c_array__", NULL));
+        if (p_capsules == NULL)
+        {
+            ThrowPythonError(env);
+        }
+
+        if (!PyTuple_Check(p_capsules) || (PyTuple_GET_SIZE(p_capsules) != 2))
+        {
+            throw Napi::TypeError::New(env, "__arrow_c_array__ must return a pair of capsules.");
+        }
+
+        auto p_array_capsule = PyTuple_GET_ITEM(p_capsules, 1);
+
+        auto schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(PyTuple_GET_ITEM(p_capsules, 0), "arrow_schema"));
+        auto array  = static_cast<ArrowArray*>(PyCapsule_GetPointer(p_array_capsule, "arrow_array"));
+        if ((schema == NULL) || (array == NULL))
+        {
+            ThrowPythonError(env);
+        }
+
+        if ((schema->release == nullptr) || (array->release == nullptr))
+        {
+            throw Napi::Error::New(env, "The Arrow array was already released.");
+        }
+
+        // The capsule owns the array, the buffers keep it alive.
+        return DescribeArray(env, schema, array, p_array_capsule);
+    }
+
+    auto p_stream_capsule = python_refs.Push(PyObject_CallMethod(p_object, "__arrow_c_stream__", NULL));
+    if (p_stream_capsule == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    auto stream = static_cast<ArrowArrayStream*>(PyCapsule_GetPointer(p_stream_capsule, "arrow_array_stream"));
+    if (stream == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    if (stream->release == nullptr)
+    {
+        throw Napi::Error::New(env, "The Arrow stream was already released.");
+    }
+
+    struct SchemaHolder
+    {
+        ArrowSchema schema {};
+
+        ~SchemaHolder() { if (schema.release != nullptr) { schema.release(&schema); } }
+    } holder;
+
+    auto status = stream->get_schema(stream, &holder.schema);
+    if (status != 0)
+    {
+        ThrowStreamError(env, stream, status);
+    }
+
+    auto n_batches = Napi::Array::New(env);
+    while (true)
+    {
+        // Every batch is owned by its own capsule, so that its buffers are released independently.
+        auto array = new ArrowArray();
+
+        auto p_owner = PyCapsule_New(array, "arrow_array", ReleaseArrayCapsule);
+        if (p_owner == NULL)
+        {
+            delete array;
+            ThrowPythonError(env);
+        }
+
+        python_refs.Push(p_owner);
+
+        status = stream->get_next(stream, array);
+        if (status != 0)
+        {
+            ThrowStreamError(env, stream, status);
+        }
+
+        if (array->release == nullptr)
+        {
+            break;
+        }
+
+        n_batches.Set(n_batches.Length(), DescribeArray(env, &holder.schema, array, p_owner));
+    }
+
+    auto n_stream = Napi::Object::New(env);
+    n_stream.Set("schema", DescribeSchema(env, &holder.schema, true));
+    n_stream.Set("batches", n_batches);
+
+    return n_stream;
+}
+
+PyObject* NPI::ToPythonArrow(const Napi::Value& n_value)
+{
+    auto env = n_value.Env();
+
+    auto root = std::make_shared<ExportRoot>();
+    root->env = env;
+
+    ParseExportNode(env, n_value, root->node, *root);
+
+    auto type = GetArrowExportType();
+    if (type == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    auto p_export = PyObject_New(ArrowExportObject, type);
+    if (p_export == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    p_export->root = new std::shared_ptr<ExportRoot>(std::move(root));
+
+    return reinterpret_cast<PyObject*>(p_export);
+}
@@ -0,0 +1,37 @@
+#ifndef NPI_ARROW_HPP
+#define NPI_ARROW_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+namespace NPI
+{
+    /**
+     * Whether the object implements the Arrow PyCapsule interface, `__arrow_c_array__` or
+     * `__arrow_c_stream__`.
+     */
+    bool IsArrowExportable(PyObject*);
+
+    /**
+     * Convert an Arrow array, record batch or stream into a description of its memory. Arrow
+     * buffers are immutable, and Node cannot write-protect an ArrayBuffer, so the buffers are
+     * copied unless the `shareReadOnly` conversion option is set. They are then external
+     * ArrayBuffers that keep the Arrow memory alive, and must not be written to.
+     *
+     * An array becomes `{ format, name, nullable, metadata, length, nullCount, offset, buffers,
+     * children, dictionary }` and a stream becomes `{ schema, batches }`, where `schema` has the
+     * fields of an array that describe its type and every batch is an array.
+     */
+    Napi::Value ToNodeArrow(const Napi::Env&, PyObject*);
+
+    /**
+     * Create a Python object that exports the described array through `__arrow_c_array__`. The
+     * description has the layout returned by ToNodeArrow, the buffers may be ArrayBuffers or views,
+     * and they are shared with the consumer, not copied.
+     *
+     * @return A new reference.
+     */
+    PyObject* ToPythonArrow(const Napi::Value&);
+}
+
+#endif
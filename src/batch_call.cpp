@@ -0,0 +1,284 @@
+#include "batch_call.hpp"
+#include "cycle_collector.hpp"
+#include "interop_helpers.hpp"
+#include "python_helpers.hpp"
+#include "release_queue.hpp"
+#include "thread_state.hpp"
+#include "type_helpers.hpp"
+
+#include <vector>
+
+namespace
+{
+    /**
+     * Convert the arguments of a call of the batch: an array of arguments, or a single argument.
+     *
+     * @return The number of positional arguments.
+     */
+    size_t ToPythonItemArguments(const Napi::Value& n_item, NPI::PythonReferences& python_args, PyObject*& p_kwnames)
+    {
+        if (n_item.IsArray())
+        {
+            return NPI::ToPythonArguments(n_item.As<Napi::Array>(), python_args, p_kwnames);
+        }
+
+        p_kwnames = NULL;
+        python_args.Push(NPI::ToPythonObject(n_item));
+
+        return 1;
+    }
+
+    /**
+     * Release the GIL for a moment after every `yield_every` calls but the last one, so that other
+     * Python threads get to run. The caller must hold the GIL.
+     */
+    void YieldGil(size_t done, size_t total, size_t yield_every)
+    {
+        if (yield_every > 0 && done % yield_every == 0 && done < total)
+        {
+            Py_BEGIN_ALLOW_THREADS
+            Py_END_ALLOW_THREADS
+        }
+    }
+
+    Napi::Array ToNodeArgumentList(const Napi::Env& env, const Napi::Value& n_args_list)
+    {
+        if (!n_args_list.IsArray())
+        {
+            throw Napi::TypeError::New(env, "The arguments of a batch must be an array.");
+        }
+
+        return n_args_list.As<Napi::Array>();
+    }
+
+    class BatchCallWorker : public Napi::AsyncWorker
+    {
+        public:
+            BatchCallWorker(const Napi::Env& env, PyObject* p_function, size_t yield_every) :
+                Napi::AsyncWorker(env, "npi.callManyAsync"),
+                m_deferred(Napi::Promise::Deferred::New(env)),
+                m_function(p_function),
+                m_yield_every(yield_every)
+            {
+                Py_INCREF(m_function);
+
+                // The arguments are owned by this worker only, out of sight of the cycle probes.
+                NPI::HoldCycleProbes();
+            }
+
+            ~BatchCallWorker()
+            {
+                // Left over when the worker did not complete.
+                for (auto& call : m_calls)
+                {
+                    for (auto p_arg : call.args)
+                    {
+                        NPI::ScheduleDecref(p_arg);
+                    }
+
+                    NPI::ScheduleDecref(call.result);
+                }
+
+                NPI::ScheduleDecref(m_function);
+                NPI::ReleaseCycleProbes();
+            }
+
+            /**
+             * Convert the arguments of a call. The caller must hold the GIL.
+             */
+            void Add(const Napi::Value& n_item)
+            {
+                m_calls.emplace_back();
+                auto& call = m_calls.back();
+
+                try
+                {
+                    NPI::PythonReferences python_args;
+                    call.positional = ToPythonItemArguments(n_item, python_args, call.kwnames);
+                    call.args       = python_args.Detach();
+                    call.converted  = true;
+                }
+                catch (const Napi::Error& error)
+                {
+                    call.conversion_error = Napi::Persistent(error.Value().As<Napi::Object>());
+                }
+            }
+
+            Napi::Promise Promise() const
+            {
+                return m_deferred.Promise();
+            }
+
+        protected:
+            void Execute() override
+            {
+                NPI::PythonWorkerGil _;
+
+                auto total = m_calls.size();
+                for (size_t i = 0; i < total; i++)
+                {
+                    auto& call = m_calls[i];
+                    if (call.converted)
+                    {
+                        call.result = PyObject_Vectorcall(m_function, call.args.data(), call.positional, call.kwnames);
+                        if (call.result == NULL)
+                        {
+                            call.error = NPI::FetchPythonError();
+                        }
+                    }
+
+                    YieldGil(i + 1, total, m_yield_every);
+                }
+
+                // Released while the GIL is still held rather than through the release queue.
+                for (auto& call : m_calls)
+                {
+                    for (auto p_arg : call.args)
+                    {
+                        Py_DECREF(p_arg);
+                    }
+
+                    call.args.clear();
+                }
+            }
+
+            void OnOK() override
+            {
+                auto env = Env();
+                NPI::PythonEnsureGil _(NPI::GilEntry::Async);
+
+                auto n_results = Napi::Array::New(env, m_calls.size());
+                for (size_t i = 0; i < m_calls.size(); i++)
+                {
+                    auto& call = m_calls[i];
+
+                    Napi::Value n_result;
+                    if (!call.converted)
+                    {
+                        n_result = call.conversion_error.Value();
+                    }
+                    else if (call.result == NULL)
+                    {
+                        n_result = NPI::ToNodeError(env, call.error).Value();
+                    }
+                    else
+                    {
+                        try
+                        {
+                            n_result = NPI::ToNodeResult(env, call.result);
+                        }
+                        catch (const Napi::Error& error)
+                        {
+                            n_result = error.Value();
+                        }
+
+                        Py_DECREF(call.result);
+                        call.result = NULL;
+                    }
+
+                    n_results.Set(static_cast<uint32_t>(i), n_result);
+                }
+
+                m_deferred.Resolve(n_results);
+            }
+
+            void OnError(const Napi::Error& error) override
+            {
+                m_deferred.Reject(error.Value());
+            }
+
+        private:
+            struct Call
+            {
+                std::vector<PyObject*> args;
+                PyObject* kwnames = NULL;
+                size_t positional = 0;
+                bool converted    = false;
+
+                Napi::ObjectReference conversion_error;
+
+                PyObject* result = NULL;
+                NPI::PythonErrorInfo error;
+            };
+
+            Napi::Promise::Deferred m_deferred;
+            PyObject* m_function;
+            size_t m_yield_every;
+            std::vector<Call> m_calls;
+    };
+}
+
+NPI::BatchOptions NPI::ParseBatchOptions(const Napi::Value& n_options)
+{
+    BatchOptions options;
+
+    if (n_options.IsObject())
+    {
+        auto n_yield_every = n_options.As<Napi::Object>().Get("yieldEvery");
+        if (n_yield_every.IsNumber())
+        {
+            auto yield_every    = n_yield_every.As<Napi::Number>().Int64Value();
+            options.yield_every = (yield_every > 0) ? static_cast<size_t>(yield_every) : 0;
+        }
+    }
+
+    return options;
+}
+
+Napi::Value NPI::CallPythonBatch(const Napi::Env& env, PyObject* p_function, const Napi::Value& n_args_list, const BatchOptions& options)
+{
+    auto n_list = ToNodeArgumentList(env, n_args_list);
+    auto total  = n_list.Length();
+
+    auto n_results = Napi::Array::New(env, total);
+    for (uint32_t i = 0; i < total; i++)
+    {
+        Napi::Value n_result;
+        try
+        {
+            PythonReferences python_args;
+
+            PyObject* python_kwnames;
+            auto positional = ToPythonItemArguments(n_list.Get(i), python_args, python_kwnames);
+
+            auto python_return = PyObject_Vectorcall(p_function, python_args.Data(), positional, python_kwnames);
+            if (python_return == NULL)
+            {
+                n_result = ToNodeError(env, FetchPythonError()).Value();
+            }
+            else
+            {
+                python_args.Push(python_return);
+                n_result = ToNodeResult(env, python_return);
+            }
+        }
+        catch (const Napi::Error& error)
+        {
+            n_result = error.Value();
+        }
+
+        n_results.Set(i, n_result);
+        YieldGil(i + 1, total, options.yield_every);
+        YieldGilIfDue();
+    }
+
+    return n_results;
+}
+
+Napi::Value NPI::CallPythonBatchAsync(const Napi::Env& env, PyObject* p_function, const Napi::Value& n_args_list, const BatchOptions& options)
+{
+    auto n_list = ToNodeArgumentList(env, n_args_list);
+    auto total  = n_list.Length();
+
+    // Owned by node-addon-api once queued, which deletes it after OnOK.
+    auto worker = new BatchCallWorker(env, p_function, options.yield_every);
+    for (uint32_t i = 0; i < total; i++)
+    {
+        worker->Add(n_list.Get(i));
+    }
+
+    auto n_promise = worker->Promise();
+    worker->Queue();
+
+    return n_promise;
+}
@@ -0,0 +1,45 @@
+#ifndef NPI_BATCH_CALL_HPP
+#define NPI_BATCH_CALL_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <cstddef>
+
+namespace NPI
+{
+    struct BatchOptions
+    {
+        /**
+         * Release the GIL briefly after every this many calls, so that other Python threads can
+         * run during a long batch. 0 never yields.
+         */
+        size_t yield_every = 0;
+    };
+
+    /**
+     * Parse `{ yieldEvery }`.
+     */
+    BatchOptions ParseBatchOptions(const Napi::Value&);
+
+    /**
+     * Call a Python callable once per element of `n_args_list`, all under the GIL hold of the
+     * caller. Each element is the array of arguments of a call, which may end with keyword
+     * arguments, or else its single argument.
+     *
+     * The results are returned in order. A call that fails, in Python or while converting, gives
+     * its Error in place of its result instead of aborting the batch.
+     */
+    Napi::Value CallPythonBatch(const Napi::Env& env, PyObject* p_function, const Napi::Value& n_args_list, const BatchOptions& options);
+
+    /**
+     * Like `CallPythonBatch`, but only the arguments are converted now. The calls run on a worker thread
+     * under a single GIL acquisition, and the results are converted back on the thread of the
+     * environment.
+     *
+     * @return A promise of the results. The caller must hold the GIL.
+     */
+    Napi::Value CallPythonBatchAsync(const Napi::Env& env, PyObject* p_function, const Napi::Value& n_args_list, const BatchOptions& options);
+}
+
+#endif
@@ -0,0 +1,252 @@
+#include "chain.hpp"
+#include "interop_helpers.hpp"
+#include "internal_helpers.h"
+#include "key_cache.hpp"
+#include "python_helpers.hpp"
+#include "release_queue.hpp"
+#include "type_helpers.hpp"
+
+Napi::FunctionReference NPI::Chain::m_constructor;
+
+namespace
+{
+    /**
+     * The root of the chain being constructed by `Chain::New`, since a wrapped object is only
+     * constructed through its constructor.
+     */
+    thread_local std::shared_ptr<PyObject> pending_root;
+
+    /**
+     * Collect the arguments of a callback from `first` on into an array, to be converted when the
+     * chain runs.
+     */
+    Napi::Array ToNodeArgumentArray(const Napi::CallbackInfo& info, size_t first)
+    {
+        auto count  = (info.Length() > first) ? info.Length() - first : 0;
+        auto n_args = Napi::Array::New(info.Env(), count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            n_args.Set(static_cast<uint32_t>(i), info[first + i]);
+        }
+
+        return n_args;
+    }
+
+    void CheckName(const Napi::Env& env, const Napi::Value& n_name)
+    {
+        if (!n_name.IsString())
+        {
+            throw Napi::TypeError::New(env, "The name of an attribute or a method must be a string.");
+        }
+    }
+}
+
+Napi::Object NPI::Chain::Init(Napi::Env env, Napi::Object exports)
+{
+    auto function = DefineClass(env, STRINGIFY(Chain),
+        {
+            InstanceMethod("getattr", &Chain::GetAttrCallback),
+            InstanceMethod("item", &Chain::GetItemCallback),
+            InstanceMethod("call", &Chain::CallCallback),
+            InstanceMethod("method", &Chain::CallMethodCallback),
+            InstanceMethod("run", &Chain::RunCallback),
+            InstanceAccessor("length", &Chain::GetLength, nullptr),
+        });
+
+    m_constructor = Napi::Persistent(function);
+    m_constructor.SuppressDestruct();
+
+    exports.Set("Chain", function);
+    return exports;
+}
+
+Napi::Value NPI::Chain::New(const Napi::Env&, PyObject* p_root)
+{
+    Py_INCREF(p_root);
+    pending_root = std::shared_ptr<PyObject>(p_root, ScheduleDecref);
+
+    return m_constructor.New({});
+}
+
+NPI::Chain::Chain(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Chain>(info), m_root(std::move(pending_root))
+{
+    if (m_root == nullptr)
+    {
+        throw Napi::TypeError::New(info.Env(), STRINGIFY(Chain) " cannot be constructed from JavaScript, use chain().");
+    }
+
+    m_operands = Napi::Persistent(Napi::Array::New(info.Env()).As<Napi::Object>());
+}
+
+Napi::Value NPI::Chain::Record(StepKind kind, const Napi::Array& n_operands)
+{
+    pending_root = m_root;
+
+    auto n_chain = m_constructor.New({});
+    auto chain   = Unwrap(n_chain);
+
+    // The operands themselves are never modified, so the new chain shares them.
+    auto n_source = m_operands.Value();
+    auto n_target = chain->m_operands.Value();
+
+    auto index = static_cast<uint32_t>(m_steps.size());
+    for (uint32_t i = 0; i < index; i++)
+    {
+        n_target.Set(i, n_source.Get(i));
+    }
+
+    n_target.Set(index, n_operands);
+
+    chain->m_steps = m_steps;
+    chain->m_steps.push_back({ kind, index });
+
+    return n_chain;
+}
+
+PyObject* NPI::Chain::Apply(const Napi::Env& env, const Step& step, PyObject* p_value)
+{
+    auto n_operands = m_operands.Value().Get(step.operands).As<Napi::Array>();
+
+    PythonReferences python_args;
+
+    switch (step.kind)
+    {
+        case StepKind::GetAttr:
+            {
+                auto python_name = python_args.Push(InternKey(env, n_operands.Get(0u)));
+                if (python_name == NULL)
+                {
+                    return NULL;
+                }
+
+                return PyObject_GetAttr(p_value, python_name);
+            }
+
+        case StepKind::GetItem:
+            {
+                auto python_key = python_args.Push(ToPythonObject(n_operands.Get(0u)));
+
+                return PyObject_GetItem(p_value, python_key);
+            }
+
+        case StepKind::Call:
+            {
+                PyObject* python_kwnames;
+                auto positional = ToPythonArguments(n_operands.Get(0u).As<Napi::Array>(), python_args, python_kwnames);
+
+                return PyObject_Vectorcall(p_value, python_args.Data(), positional, python_kwnames);
+            }
+
+        case StepKind::CallMethod:
+            {
+                auto python_name = python_args.Push(InternKey(env, n_operands.Get(0u)));
+                if (python_name == NULL)
+                {
+                    return NULL;
+                }
+
+                Py_INCREF(p_value);
+                python_args.Push(p_value);
+
+                PyObject* python_kwnames;
+                auto positional = ToPythonArguments(n_operands.Get(1u).As<Napi::Array>(), python_args, python_kwnames);
+
+                return PyObject_VectorcallMethod(python_name, python_args.Data() + 1, positional + 1, python_kwnames);
+            }
+    }
+
+    return NULL;
+}
+
+Napi::Value NPI::Chain::GetAttrCallback(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    CheckName(env, info[0]);
+
+    auto n_operands = Napi::Array::New(env, 1);
+    n_operands.Set(0u, info[0]);
+
+    return Record(StepKind::GetAttr, n_operands);
+}
+
+Napi::Value NPI::Chain::GetItemCallback(const Napi::CallbackInfo& info)
+{
+    auto n_operands = Napi::Array::New(info.Env(), 1);
+    n_operands.Set(0u, info[0]);
+
+    return Record(StepKind::GetItem, n_operands);
+}
+
+Napi::Value NPI::Chain::CallCallback(const Napi::CallbackInfo& info)
+{
+    auto n_operands = Napi::Array::New(info.Env(), 1);
+    n_operands.Set(0u, ToNodeArgumentArray(info, 0));
+
+    return Record(StepKind::Call, n_operands);
+}
+
+Napi::Value NPI::Chain::CallMethodCallback(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    CheckName(env, info[0]);
+
+    auto n_operands = Napi::Array::New(env, 2);
+    n_operands.Set(0u, info[0]);
+    n_operands.Set(1u, ToNodeArgumentArray(info, 1));
+
+    return Record(StepKind::CallMethod, n_operands);
+}
+
+Napi::Value NPI::Chain::RunCallback(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+
+        // Only the current value is kept, so that the intermediate values are released as soon
+        // as the next step is done with them.
+        auto python_value = m_root.get();
+        Py_INCREF(python_value);
+
+        for (const auto& step : m_steps)
+        {
+            PyObject* python_next;
+            try
+            {
+                python_next = Apply(env, step, python_value);
+            }
+            catch (...)
+            {
+                Py_DECREF(python_value);
+                throw;
+            }
+
+            if (python_next == NULL)
+            {
+                auto error = FetchPythonError();
+                Py_DECREF(python_value);
+
+                throw ToNodeError(env, error);
+            }
+
+            Py_DECREF(python_value);
+            python_value = python_next;
+
+            YieldGilIfDue();
+        }
+
+        PythonReferences python_values;
+        python_values.Push(python_value);
+
+        return ToNodeResult(env, python_value);
+    }
+}
+
+Napi::Value NPI::Chain::GetLength(const Napi::CallbackInfo& info)
+{
+    return Napi::Number::New(info.Env(), static_cast<double>(m_steps.size()));
+}
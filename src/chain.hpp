@@ -0,0 +1,93 @@
+#ifndef NPI_CHAIN_HPP
+#define NPI_CHAIN_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NPI
+{
+    /**
+     * A lazy pipeline of Python operations, such as
+     * `npi.chain(df).method("groupby", "key").method("agg", "sum").getattr("values")`.
+     *
+     * The operations are only recorded, without entering Python. Each one returns a new chain and
+     * leaves its receiver as it was, so a common prefix can be extended in several ways. `run()`
+     * replays them under a single GIL acquisition, and only the final value is converted. A chain
+     * can be run any number of times.
+     */
+    class Chain : public Napi::ObjectWrap<Chain>
+    {
+        public:
+            static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+            /**
+             * Start a chain from a Python object.
+             *
+             * @param p_root A borrowed reference, which the chain keeps. The caller must hold the
+             *               GIL.
+             */
+            static Napi::Value New(const Napi::Env& env, PyObject* p_root);
+
+            Chain(const Napi::CallbackInfo& info);
+
+        private:
+            enum class StepKind
+            {
+                GetAttr,
+                GetItem,
+                Call,
+                CallMethod,
+            };
+
+            struct Step
+            {
+                StepKind kind;
+                uint32_t operands;
+            };
+
+            /**
+             * Return a new chain made of the steps of this one followed by another step.
+             */
+            Napi::Value Record(StepKind kind, const Napi::Array& n_operands);
+
+            /**
+             * Apply a step to the current value. The caller must hold the GIL.
+             *
+             * @return A new reference, or `NULL` with a Python exception set.
+             */
+            PyObject* Apply(const Napi::Env& env, const Step& step, PyObject* p_value);
+
+            Napi::Value GetAttrCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value GetItemCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value CallCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value CallMethodCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value RunCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value GetLength(const Napi::CallbackInfo& info);
+
+            static Napi::FunctionReference m_constructor;
+
+            /**
+             * Shared by the chains extended from the same root. Released through the release
+             * queue, since finalizers may run without the GIL.
+             */
+            std::shared_ptr<PyObject> m_root;
+
+            std::vector<Step> m_steps;
+
+            /**
+             * The operands of every step, an array of arrays indexed by `Step::operands`.
+             */
+            Napi::ObjectReference m_operands;
+    };
+};
+
+#endif
@@ -0,0 +1,861 @@
+#include "columnar.hpp"
+#include "interop_helpers.hpp"
+#include "key_cache.hpp"
+#include "python_helpers.hpp"
+#include "type_helpers.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    /**
+     * A validity bitmap in the layout of Arrow: bit `i % 8` of byte `i / 8` is set when the value
+     * `i` is present. Only allocated on the first null, so that columns without one pay nothing.
+     */
+    class ValidityBitmap
+    {
+        public:
+            explicit ValidityBitmap(size_t length) : m_length(length) {}
+
+            void SetNull(size_t row)
+            {
+                if (m_bits.empty())
+                {
+                    m_bits.assign((m_length + 7) / 8, 0xFF);
+                }
+
+                m_bits[row / 8] &= static_cast<uint8_t>(~(1u << (row % 8)));
+            }
+
+            bool HasNulls() const { return !m_bits.empty(); }
+
+            /**
+             * @return A Uint8Array, or null when every value is present.
+             */
+            Napi::Value Finish(const Napi::Env& env) const
+            {
+                if (m_bits.empty())
+                {
+                    return env.Null();
+                }
+
+                auto n_bits = Napi::Uint8Array::New(env, m_bits.size(), napi_uint8_array);
+                std::memcpy(n_bits.Data(), m_bits.data(), m_bits.size());
+
+                return n_bits;
+            }
+
+        private:
+            size_t m_length;
+
+            std::vector<uint8_t> m_bits;
+    };
+
+    /**
+     * Accumulates strings into the packed layout of NPI::ToNodeColumns.
+     */
+    class StringPacker
+    {
+        public:
+            explicit StringPacker(size_t length) : m_validity(length)
+            {
+                m_offsets.reserve(length + 1);
+                m_offsets.push_back(0);
+            }
+
+            void Append(const Napi::Env& env, PyObject* p_value)
+            {
+                if ((p_value == NULL) || (p_value == Py_None))
+                {
+                    m_validity.SetNull(m_offsets.size() - 1);
+                }
+                else
+                {
+                    auto p_string = PyUnicode_Check(p_value) ? (Py_INCREF(p_value), p_value) : PyObject_Str(p_value);
+                    if (p_string == NULL)
+                    {
+                        NPI::ThrowPythonError(env);
+                    }
+
+                    Py_ssize_t length;
+                    auto data = PyUnicode_AsUTF8AndSize(p_string, &length);
+                    if (data == NULL)
+                    {
+                        Py_DECREF(p_string);
+                        NPI::ThrowPythonError(env);
+                    }
+
+                    m_bytes.append(data, length);
+                    Py_DECREF(p_string);
+                }
+
+                if (m_bytes.size() > std::numeric_limits<uint32_t>::max())
+                {
+                    throw Napi::RangeError::New(env, "The strings of a column exceed 4 GiB.");
+                }
+
+                m_offsets.push_back(static_cast<uint32_t>(m_bytes.size()));
+            }
+
+            Napi::Value Finish(const Napi::Env& env)
+            {
+                auto n_offsets = Napi::Uint32Array::New(env, m_offsets.size(), napi_uint32_array);
+                std::memcpy(n_offsets.Data(), m_offsets.data(), m_offsets.size() * sizeof(uint32_t));
+
+                auto n_data = Napi::Uint8Array::New(env, m_bytes.size(), napi_uint8_array);
+                std::memcpy(n_data.Data(), m_bytes.data(), m_bytes.size());
+
+                auto n_column = Napi::Object::New(env);
+                n_column.Set("offsets", n_offsets);
+                n_column.Set("data", n_data);
+                n_column.Set("validity", m_validity.Finish(env));
+
+                return n_column;
+            }
+
+        private:
+            std::vector<uint32_t> m_offsets;
+
+            std::string m_bytes;
+
+            ValidityBitmap m_validity;
+    };
+
+    /**
+     * Writes the values of a single column while the records are walked.
+     */
+    class ColumnWriter
+    {
+        public:
+            /**
+             * @param nullable Whether nulls are kept in a validity bitmap. Otherwise they are NaN in
+             *                 float columns, and rejected in integer and boolean columns.
+             * @param inferred Whether the column only comes with its bitmap when a null was seen,
+             *                 so that inferred columns without nulls look like declared ones.
+             */
+            ColumnWriter(const Napi::Env& env, std::string name, NPI::ColumnType type, bool nullable, bool inferred, size_t length)
+                : m_name(std::move(name)), m_type(type), m_nullable(nullable), m_inferred(inferred), m_validity(length), m_data(nullptr), m_strings(nullptr)
+            {
+                switch (m_type)
+                {
+                    case NPI::ColumnType::Float64:
+                        m_array = Napi::Float64Array::New(env, length, napi_float64_array);
+                        break;
+                    case NPI::ColumnType::Float32:
+                        m_array = Napi::TypedArrayOf<float>::New(env, length, napi_float32_array);
+                        break;
+                    case NPI::ColumnType::Int32:
+                        m_array = Napi::Int32Array::New(env, length, napi_int32_array);
+                        break;
+                    case NPI::ColumnType::Int64:
+                        m_array = Napi::TypedArrayOf<int64_t>::New(env, length, napi_bigint64_array);
+                        break;
+                    case NPI::ColumnType::Bool:
+                        m_array = Napi::Uint8Array::New(env, length, napi_uint8_array);
+                        break;
+                    case NPI::ColumnType::String:
+                        m_strings = std::unique_ptr<StringPacker>(new StringPacker(length));
+                        break;
+                    case NPI::ColumnType::Any:
+                        m_array = Napi::Array::New(env, length);
+                        break;
+                }
+
+                if (m_array.IsTypedArray())
+                {
+                    auto n_typed_array = m_array.As<Napi::TypedArray>();
+                    m_data = static_cast<uint8_t*>(n_typed_array.ArrayBuffer().Data()) + n_typed_array.ByteOffset();
+                }
+            }
+
+            const std::string& Name() const { return m_name; }
+
+            /**
+             * Write the value of a row, `NULL` when the record has no such field.
+             */
+            void Write(const Napi::Env& env, size_t row, PyObject* p_value)
+            {
+                auto is_null = (p_value == NULL) || (p_value == Py_None);
+
+                if (is_null && (m_type != NPI::ColumnType::String) && (m_type != NPI::ColumnType::Any))
+                {
+                    if (m_nullable)
+                    {
+                        m_validity.SetNull(row);
+                    }
+                    else if ((m_type != NPI::ColumnType::Float64) && (m_type != NPI::ColumnType::Float32))
+                    {
+                        throw Napi::TypeError::New(env, "The column " + m_name + " has no value at row " + std::to_string(row) + ", declare its type with a trailing ? to allow nulls.");
+                    }
+                }
+
+                switch (m_type)
+                {
+                    case NPI::ColumnType::Float64:
+                        reinterpret_cast<double*>(m_data)[row] = is_null ? NAN : ToDouble(env, p_value);
+                        break;
+                    case NPI::ColumnType::Float32:
+                        reinterpret_cast<float*>(m_data)[row] = is_null ? NAN : static_cast<float>(ToDouble(env, p_value));
+                        break;
+                    case NPI::ColumnType::Int32:
+                        reinterpret_cast<int32_t*>(m_data)[row] = is_null ? 0 : ToInt32(env, p_value);
+                        break;
+                    case NPI::ColumnType::Int64:
+                        reinterpret_cast<int64_t*>(m_data)[row] = is_null ? 0 : ToInt64(env, p_value);
+                        break;
+                    case NPI::ColumnType::Bool:
+                        m_data[row] = is_null ? 0 : ToBool(env, p_value);
+                        break;
+                    case NPI::ColumnType::String:
+                        m_strings->Append(env, p_value);
+                        break;
+                    case NPI::ColumnType::Any:
+                        m_array.As<Napi::Array>().Set(static_cast<uint32_t>(row), is_null ? env.Undefined() : NPI::ToNodeValue(env, p_value));
+                        break;
+                }
+            }
+
+            Napi::Value Finish(const Napi::Env& env)
+            {
+                if (m_strings != nullptr)
+                {
+                    return m_strings->Finish(env);
+                }
+
+                if (!m_nullable || (m_type == NPI::ColumnType::Any) || (m_inferred && !m_validity.HasNulls()))
+                {
+                    return m_array;
+                }
+
+                auto n_column = Napi::Object::New(env);
+                n_column.Set("values", m_array);
+                n_column.Set("validity", m_validity.Finish(env));
+
+                return n_column;
+            }
+
+        private:
+            static double ToDouble(const Napi::Env& env, PyObject* p_value)
+            {
+                if (PyFloat_CheckExact(p_value)) { return PyFloat_AS_DOUBLE(p_value); }
+
+                auto value = PyFloat_AsDouble(p_value);
+                if ((value == -1.0) && PyErr_Occurred()) { NPI::ThrowPythonError(env); }
+
+                return value;
+            }
+
+            static int32_t ToInt32(const Napi::Env& env, PyObject* p_value)
+            {
+                auto value = PyLong_AsLong(p_value);
+                if ((value == -1) && PyErr_Occurred()) { NPI::ThrowPythonError(env); }
+
+                if ((value < std::numeric_limits<int32_t>::min()) || (value > std::numeric_limits<int32_t>::max()))
+                {
+                    throw Napi::RangeError::New(env, "A value does not fit in an i32 column.");
+                }
+
+                return static_cast<int32_t>(value);
+            }
+
+            static int64_t ToInt64(const Napi::Env& env, PyObject* p_value)
+            {
+                auto value = PyLong_AsLongLong(p_value);
+                if ((value == -1) && PyErr_Occurred()) { NPI::ThrowPythonError(env); }
+
+                return value;
+            }
+
+            static uint8_t ToBool(const Napi::Env& env, PyObject* p_value)
+            {
+                auto value = PyObject_IsTrue(p_value);
+                if (value == -1) { NPI::ThrowPythonError(env); }
+
+                return static_cast<uint8_t>(value);
+            }
+
+            std::string m_name;
+
+            NPI::ColumnType m_type;
+
+            bool m_nullable;
+
+            bool m_inferred;
+
+            ValidityBitmap m_validity;
+
+            Napi::Value m_array;
+
+            uint8_t* m_data;
+
+            std::unique_ptr<StringPacker> m_strings;
+    };
+
+    /**
+     * Infer the type of a column from a value of it.
+     */
+    NPI::ColumnType InferColumnType(PyObject* p_value)
+    {
+        if (PyBool_Check(p_value))    { return NPI::ColumnType::Bool; }
+        if (PyLong_Check(p_value))    { return NPI::ColumnType::Int64; }
+        if (PyFloat_Check(p_value))   { return NPI::ColumnType::Float64; }
+        if (PyUnicode_Check(p_value)) { return NPI::ColumnType::String; }
+
+        return NPI::ColumnType::Any;
+    }
+
+    /**
+     * Get a field of a record, as a borrowed reference or `NULL` when it is missing.
+     *
+     * @param p_record The record, either a dict or the result of PySequence_Fast.
+     */
+    PyObject* GetField(PyObject* p_record, PyObject* p_key, Py_ssize_t position)
+    {
+        if (PyDict_Check(p_record))
+        {
+            return PyDict_GetItem(p_record, p_key);
+        }
+
+        return (position < PySequence_Fast_GET_SIZE(p_record)) ? PySequence_Fast_GET_ITEM(p_record, position) : NULL;
+    }
+}
+
+NPI::ColumnType NPI::ParseColumnType(const Napi::Env& env, const std::string& text, bool& nullable)
+{
+    nullable = !text.empty() && (text.back() == '?');
+
+    auto name = nullable ? text.substr(0, text.size() - 1) : text;
+
+    if (name == "f64")  { return ColumnType::Float64; }
+    if (name == "f32")  { return ColumnType::Float32; }
+    if (name == "i32")  { return ColumnType::Int32; }
+    if (name == "i64")  { return ColumnType::Int64; }
+    if (name == "bool") { return ColumnType::Bool; }
+    if (name == "str")  { return ColumnType::String; }
+    if (name == "any")  { return ColumnType::Any; }
+
+    throw Napi::TypeError::New(env, "Unknown column type: " + name);
+}
+
+Napi::Value NPI::ToNodeColumns(const Napi::Env& env, PyObject* p_records, const Napi::Value& n_schema)
+{
+    auto p_rows = PySequence_Fast(p_records, "The records must be a sequence.");
+    if (p_rows == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    std::vector<PyObject*> p_records_fast;
+    std::vector<PyObject*> p_keys;
+
+    try
+    {
+        auto length = static_cast<size_t>(PySequence_Fast_GET_SIZE(p_rows));
+
+        // Normalize every record once, so that the columns are written in a single pass.
+        p_records_fast.reserve(length);
+        for (size_t row = 0; row < length; row++)
+        {
+            auto p_record = PySequence_Fast_GET_ITEM(p_rows, row);
+            auto p_fast   = PyDict_Check(p_record) ? (Py_INCREF(p_record), p_record) : PySequence_Fast(p_record, "A record must be a dict or a sequence.");
+            if (p_fast == NULL)
+            {
+                ThrowPythonError(env);
+            }
+
+            p_records_fast.push_back(p_fast);
+        }
+
+        std::vector<std::string> names;
+        std::vector<bool>        inferred;
+        std::vector<bool>        nullable;
+        std::vector<ColumnType>  types;
+
+        if (n_schema.IsArray())
+        {
+            auto n_names = n_schema.As<Napi::Array>();
+            for (uint32_t i = 0; i < n_names.Length(); i++)
+            {
+                names.push_back(n_names.Get(i).ToString().Utf8Value());
+                types.push_back(ColumnType::Any);
+                inferred.push_back(true);
+                nullable.push_back(true);
+            }
+        }
+        else if (n_schema.IsObject())
+        {
+            auto n_types = n_schema.As<Napi::Object>();
+            auto n_names = n_types.GetPropertyNames();
+            for (uint32_t i = 0; i < n_names.Length(); i++)
+            {
+                auto name = n_names.Get(i).ToString().Utf8Value();
+
+                bool is_nullable;
+                types.push_back(ParseColumnType(env, n_types.Get(name).ToString().Utf8Value(), is_nullable));
+                names.push_back(std::move(name));
+                inferred.push_back(false);
+                nullable.push_back(is_nullable);
+            }
+        }
+        else if (length > 0)
+        {
+            auto p_first = p_records_fast[0];
+            if (PyDict_Check(p_first))
+            {
+                Py_ssize_t position = 0;
+                PyObject*  p_key;
+                PyObject*  p_value;
+
+                while (PyDict_Next(p_first, &position, &p_key, &p_value))
+                {
+                    auto name = PyUnicode_Check(p_key) ? PyUnicode_AsUTF8(p_key) : NULL;
+                    if (name == NULL)
+                    {
+                        throw Napi::TypeError::New(env, "The keys of a record must be strings.");
+                    }
+
+                    names.push_back(name);
+                    types.push_back(ColumnType::Any);
+                    inferred.push_back(true);
+                    nullable.push_back(true);
+                }
+            }
+            else
+            {
+                for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(p_first); i++)
+                {
+                    names.push_back(std::to_string(i));
+                    types.push_back(ColumnType::Any);
+                    inferred.push_back(true);
+                    nullable.push_back(true);
+                }
+            }
+        }
+
+        auto columns = names.size();
+
+        p_keys.reserve(columns);
+        for (auto& name : names)
+        {
+            auto p_key = InternKey(name.data(), name.size());
+            if (p_key == NULL)
+            {
+                ThrowPythonError(env);
+            }
+
+            p_keys.push_back(p_key);
+        }
+
+        // Infer the types from the first value of each column that is not None.
+        for (size_t column = 0; column < columns; column++)
+        {
+            if (!inferred[column]) { continue; }
+
+            for (size_t row = 0; row < length; row++)
+            {
+                auto p_value = GetField(p_records_fast[row], p_keys[column], column);
+                if ((p_value != NULL) && (p_value != Py_None))
+                {
+                    types[column] = InferColumnType(p_value);
+                    break;
+                }
+            }
+
+            // Inferred float columns keep NaN for nulls, as the other float columns do.
+            nullable[column] = (types[column] != ColumnType::Float64);
+        }
+
+        std::vector<ColumnWriter> writers;
+        writers.reserve(columns);
+        for (size_t column = 0; column < columns; column++)
+        {
+            writers.emplace_back(env, names[column], types[column], nullable[column], inferred[column], length);
+        }
+
+        for (size_t row = 0; row < length; row++)
+        {
+            auto p_record = p_records_fast[row];
+
+            for (size_t column = 0; column < columns; column++)
+            {
+                writers[column].Write(env, row, GetField(p_record, p_keys[column], column));
+            }
+
+            NPI::YieldGilIfDue();
+        }
+
+        auto n_columns = Napi::Object::New(env);
+        for (auto& writer : writers)
+        {
+            n_columns.Set(writer.Name(), writer.Finish(env));
+        }
+
+        for (auto p_key : p_keys) { Py_DECREF(p_key); }
+        for (auto p_record : p_records_fast) { Py_DECREF(p_record); }
+        Py_DECREF(p_rows);
+
+        return n_columns;
+    }
+    catch (...)
+    {
+        for (auto p_key : p_keys) { Py_DECREF(p_key); }
+        for (auto p_record : p_records_fast) { Py_DECREF(p_record); }
+        Py_DECREF(p_rows);
+
+        throw;
+    }
+}
+
+Napi::Value NPI::ToNodePackedStrings(const Napi::Env& env, PyObject* p_sequence)
+{
+    auto p_items = PySequence_Fast(p_sequence, "The values must be a sequence.");
+    if (p_items == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    try
+    {
+        auto length = static_cast<size_t>(PySequence_Fast_GET_SIZE(p_items));
+
+        StringPacker packer(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            packer.Append(env, PySequence_Fast_GET_ITEM(p_items, i));
+        }
+
+        Py_DECREF(p_items);
+        return packer.Finish(env);
+    }
+    catch (...)
+    {
+        Py_DECREF(p_items);
+        throw;
+    }
+}
+
+namespace
+{
+    /**
+     * The typed array type of a buffer format with the given item size, or -1 when there is none.
+     */
+    int ToTypedArrayType(const char* format, Py_ssize_t itemsize)
+    {
+        if (format == NULL) { format = "B"; }
+
+        if ((*format == '@') || (*format == '=') || (*format == '<'))
+        {
+            format++;
+        }
+
+        if ((format[0] == '\0') || (format[1] != '\0'))
+        {
+            return -1;
+        }
+
+        switch (format[0])
+        {
+            case 'b': case 'h': case 'i': case 'l': case 'q':
+                switch (itemsize)
+                {
+                    case 1: return napi_int8_array;
+                    case 2: return napi_int16_array;
+                    case 4: return napi_int32_array;
+                    case 8: return napi_bigint64_array;
+                }
+                break;
+            case 'B': case 'H': case 'I': case 'L': case 'Q': case '?':
+                switch (itemsize)
+                {
+                    case 1: return napi_uint8_array;
+                    case 2: return napi_uint16_array;
+                    case 4: return napi_uint32_array;
+                    case 8: return napi_biguint64_array;
+                }
+                break;
+            case 'f':
+                return (itemsize == 4) ? napi_float32_array : -1;
+            case 'd':
+                return (itemsize == 8) ? napi_float64_array : -1;
+        }
+
+        return -1;
+    }
+
+    /**
+     * Expose a one-dimensional NumPy array as a typed array over the same memory. The memory view
+     * taken on the array owns the buffer export for as long as the typed array lives.
+     */
+    Napi::Value ToNodeSharedColumn(const Napi::Env& env, PyObject* p_numpy, PyObject* p_array)
+    {
+        NPI::PythonReferences python_refs;
+
+        auto p_contiguous = python_refs.Push(PyObject_CallMethod(p_numpy, "ascontiguousarray", "O", p_array));
+        if (p_contiguous == NULL)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        auto p_view = python_refs.Push(PyMemoryView_FromObject(p_contiguous));
+        if (p_view == NULL)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        auto buffer = PyMemoryView_GET_BUFFER(p_view);
+        auto type   = ToTypedArrayType(buffer->format, buffer->itemsize);
+
+        if ((type < 0) || (buffer->ndim != 1))
+        {
+            auto p_list = python_refs.Push(PyObject_CallMethod(p_contiguous, "tolist", NULL));
+            if (p_list == NULL)
+            {
+                NPI::ThrowPythonError(env);
+            }
+
+            return NPI::ToNodeArray(env, p_list);
+        }
+
+        Napi::Value n_buffer;
+        if ((reinterpret_cast<uintptr_t>(buffer->buf) % buffer->itemsize) == 0)
+        {
+            n_buffer = NPI::ToNodeSharedBuffer(env, buffer->buf, buffer->len, p_view, buffer->readonly != 0);
+        }
+        else
+        {
+            // Typed arrays must be aligned to their element size.
+            auto n_copy = Napi::ArrayBuffer::New(env, buffer->len);
+            std::memcpy(n_copy.Data(), buffer->buf, buffer->len);
+
+            n_buffer = n_copy;
+        }
+
+        napi_value n_array;
+        if (napi_create_typedarray(env, static_cast<napi_typedarray_type>(type), buffer->len / buffer->itemsize, n_buffer, 0, &n_array) != napi_ok)
+        {
+            throw Napi::Error::New(env);
+        }
+
+        return Napi::Value(env, n_array);
+    }
+
+    /**
+     * Call `to_numpy(dtype=..., na_value=...)` on a Series or an Index.
+     *
+     * @return A new reference.
+     */
+    PyObject* ToNumpy(PyObject* p_values, PyObject* p_dtype, PyObject* p_na_value)
+    {
+        auto p_method = PyObject_GetAttrString(p_values, "to_numpy");
+        if (p_method == NULL)
+        {
+            return NULL;
+        }
+
+        auto p_args   = PyTuple_New(0);
+        auto p_kwargs = Py_BuildValue("{s:O,s:O}", "dtype", p_dtype, "na_value", p_na_value);
+
+        auto p_result = ((p_args != NULL) && (p_kwargs != NULL)) ? PyObject_Call(p_method, p_args, p_kwargs) : NULL;
+
+        Py_XDECREF(p_kwargs);
+        Py_XDECREF(p_args);
+        Py_DECREF(p_method);
+
+        return p_result;
+    }
+
+    /**
+     * Convert a Series or an Index into a column.
+     *
+     * @param dtype_name Receives the name of the dtype of the values.
+     */
+    Napi::Value ToNodeSeries(const Napi::Env& env, PyObject* p_numpy, PyObject* p_values, std::string& dtype_name)
+    {
+        NPI::PythonReferences python_refs;
+
+        auto p_dtype = python_refs.Push(PyObject_GetAttrString(p_values, "dtype"));
+        auto p_name  = (p_dtype != NULL) ? python_refs.Push(PyObject_Str(p_dtype)) : NULL;
+        auto p_kind  = (p_dtype != NULL) ? python_refs.Push(PyObject_GetAttrString(p_dtype, "kind")) : NULL;
+        if ((p_name == NULL) || (p_kind == NULL))
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        dtype_name = PyUnicode_AsUTF8(p_name);
+
+        if (dtype_name == "category")
+        {
+            // A CategoricalIndex has the codes and categories itself, a Series behind `.cat`.
+            auto p_accessor   = PyObject_HasAttrString(p_values, "cat") ? python_refs.Push(PyObject_GetAttrString(p_values, "cat")) : p_values;
+            auto p_codes      = (p_accessor != NULL) ? python_refs.Push(PyObject_GetAttrString(p_accessor, "codes")) : NULL;
+            auto p_categories = (p_codes != NULL) ? python_refs.Push(PyObject_GetAttrString(p_accessor, "categories")) : NULL;
+            if (p_categories == NULL)
+            {
+                NPI::ThrowPythonError(env);
+            }
+
+            std::string categories_dtype;
+
+            auto n_column = Napi::Object::New(env);
+            n_column.Set("codes", ToNodeSharedColumn(env, p_numpy, p_codes));
+            n_column.Set("categories", ToNodeSeries(env, p_numpy, p_categories, categories_dtype));
+
+            return n_column;
+        }
+
+        auto p_numpy_dtype = python_refs.Push(PyObject_GetAttrString(p_numpy, "dtype"));
+        if (p_numpy_dtype == NULL)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        auto kind     = PyUnicode_Check(p_kind) ? PyUnicode_AsUTF8(p_kind)[0] : 'O';
+        auto numeric  = (kind == 'i') || (kind == 'u') || (kind == 'f') || (kind == 'b');
+        auto is_numpy = PyObject_IsInstance(p_dtype, p_numpy_dtype);
+        if (is_numpy < 0)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        if ((kind == 'M') || (kind == 'm'))
+        {
+            // Datetimes and timedeltas are exposed as their int64 ticks, in the unit of the dtype.
+            auto p_array = python_refs.Push(PyObject_GetAttrString(p_values, "values"));
+            auto p_ticks = (p_array != NULL) ? python_refs.Push(PyObject_CallMethod(p_array, "view", "s", "i8")) : NULL;
+            if (p_ticks == NULL)
+            {
+                NPI::ThrowPythonError(env);
+            }
+
+            return ToNodeSharedColumn(env, p_numpy, p_ticks);
+        }
+
+        if (numeric && is_numpy)
+        {
+            auto p_array = python_refs.Push(PyObject_CallMethod(p_values, "to_numpy", NULL));
+            if (p_array == NULL)
+            {
+                NPI::ThrowPythonError(env);
+            }
+
+            return ToNodeSharedColumn(env, p_numpy, p_array);
+        }
+
+        if (numeric)
+        {
+            // Nullable extension columns have no NumPy array to share, NA becomes NaN.
+            auto p_float64 = python_refs.Push(PyUnicode_FromString("float64"));
+            auto p_nan     = python_refs.Push(PyFloat_FromDouble(NAN));
+            auto p_array   = python_refs.Push(ToNumpy(p_values, p_float64, p_nan));
+            if (p_array == NULL)
+            {
+                NPI::ThrowPythonError(env);
+            }
+
+            return ToNodeSharedColumn(env, p_numpy, p_array);
+        }
+
+        auto p_objects = python_refs.Push(ToNumpy(p_values, reinterpret_cast<PyObject*>(&PyBaseObject_Type), Py_None));
+        if (p_objects == NULL)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        return NPI::ToNodePackedStrings(env, p_objects);
+    }
+}
+
+Napi::Value NPI::ToNodeDataFrame(const Napi::Env& env, PyObject* p_frame)
+{
+    PythonReferences python_refs;
+
+    auto p_numpy  = python_refs.Push(PyImport_ImportModule("numpy"));
+    auto p_pandas = (p_numpy != NULL) ? python_refs.Push(PyImport_ImportModule("pandas")) : NULL;
+    if (p_pandas == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    auto length = PyObject_Length(p_frame);
+    if (length < 0)
+    {
+        ThrowPythonError(env);
+    }
+
+    auto n_columns = Napi::Object::New(env);
+    auto n_dtypes  = Napi::Object::New(env);
+
+    auto p_items    = python_refs.Push(PyObject_CallMethod(p_frame, "items", NULL));
+    auto p_iterator = (p_items != NULL) ? python_refs.Push(PyObject_GetIter(p_items)) : NULL;
+    if (p_iterator == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    while (auto p_item = PyIter_Next(p_iterator))
+    {
+        PythonReferences item_refs;
+        item_refs.Push(p_item);
+
+        PyObject* p_name;
+        PyObject* p_series;
+        if (!PyArg_ParseTuple(p_item, "OO", &p_name, &p_series))
+        {
+            ThrowPythonError(env);
+        }
+
+        auto p_label = item_refs.Push(PyObject_Str(p_name));
+        if (p_label == NULL)
+        {
+            ThrowPythonError(env);
+        }
+
+        auto name = std::string(PyUnicode_AsUTF8(p_label));
+
+        // Labels are keyed by their string form, so `1` and `"1"`, or a repeated label, would
+        // overwrite each other.
+        if (n_columns.HasOwnProperty(name))
+        {
+            throw Napi::Error::New(env, "The DataFrame has more than one column labeled " + name + ".");
+        }
+
+        std::string dtype_name;
+        n_columns.Set(name, ToNodeSeries(env, p_numpy, p_series, dtype_name));
+        n_dtypes.Set(name, Napi::String::New(env, dtype_name));
+    }
+
+    if (PyErr_Occurred())
+    {
+        ThrowPythonError(env);
+    }
+
+    auto p_index       = python_refs.Push(PyObject_GetAttrString(p_frame, "index"));
+    auto p_range_index = (p_index != NULL) ? python_refs.Push(PyObject_GetAttrString(p_pandas, "RangeIndex")) : NULL;
+    auto is_range      = (p_range_index != NULL) ? PyObject_IsInstance(p_index, p_range_index) : -1;
+    if (is_range < 0)
+    {
+        ThrowPythonError(env);
+    }
+
+    auto n_frame = Napi::Object::New(env);
+    n_frame.Set("length", Napi::Number::New(env, static_cast<double>(length)));
+
+    if (is_range)
+    {
+        n_frame.Set("index", env.Null());
+    }
+    else
+    {
+        std::string index_dtype;
+        n_frame.Set("index", ToNodeSeries(env, p_numpy, p_index, index_dtype));
+    }
+
+    n_frame.Set("columns", n_columns);
+    n_frame.Set("dtypes", n_dtypes);
+
+    return n_frame;
+}
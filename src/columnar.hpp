@@ -0,0 +1,73 @@
+#ifndef NPI_COLUMNAR_HPP
+#define NPI_COLUMNAR_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <string>
+
+namespace NPI
+{
+    /**
+     * The types of a column produced by the columnar converters.
+     */
+    enum class ColumnType
+    {
+        Float64,
+        Float32,
+        Int32,
+        Int64,
+        Bool,
+        String,
+        Any,
+    };
+
+    /**
+     * Parse the name of a column type (`f64`, `f32`, `i32`, `i64`, `bool`, `str` or `any`). A
+     * trailing `?` marks the column as nullable.
+     */
+    ColumnType ParseColumnType(const Napi::Env& env, const std::string& text, bool& nullable);
+
+    /**
+     * Convert records, a sequence of dicts or of tuples, into columns in a single pass.
+     *
+     * Numeric columns are written straight into typed arrays, string columns into a packed layout
+     * of `{ offsets: Uint32Array, data: Uint8Array, validity }` where the string `i` is the UTF-8
+     * bytes between `offsets[i]` and `offsets[i + 1]`, and `any` columns into plain arrays.
+     *
+     * `validity` is an Arrow validity bitmap, or null when no value is missing. Numeric and boolean
+     * columns declared with a trailing `?` become `{ values, validity }`, and so do inferred integer
+     * and boolean columns in which a null was seen. Otherwise nulls are NaN in float columns, and
+     * rejected with a TypeError in integer and boolean columns. `any` columns keep them as
+     * `undefined`.
+     *
+     * @param env       The current Node environment.
+     * @param p_records The records to convert. The caller must hold the GIL.
+     * @param n_schema  Either an object of column names to types, an array of column names, or
+     *                  nothing to infer the columns from the first record. Inferred columns
+     *                  of ints are `i64`, so that large ids are not rounded.
+     */
+    Napi::Value ToNodeColumns(const Napi::Env& env, PyObject* p_records, const Napi::Value& n_schema);
+
+    /**
+     * Pack a sequence of Python objects into the packed string layout of `ToNodeColumns`. Objects
+     * that are not strings are converted with `str()`, and `None` is marked in the validity bitmap.
+     */
+    Napi::Value ToNodePackedStrings(const Napi::Env& env, PyObject* p_sequence);
+
+    /**
+     * Convert a pandas DataFrame into `{ length, index, columns, dtypes }` from the NumPy array of
+     * each column.
+     *
+     * Numeric, boolean and datetime columns become typed arrays that share the memory of the array,
+     * unless it is read-only (copy-on-write blocks, `writeable=False`) and the `shareReadOnly`
+     * conversion option is off, in which case they are copied. Categorical columns become
+     * `{ codes, categories }`, and object or string columns use the packed string layout.
+     * Nullable extension columns are converted to float64 with NaN for NA. `index` is null for a
+     * RangeIndex. Columns are keyed by the `str()` of their label, and labels that collide that
+     * way are rejected.
+     */
+    Napi::Value ToNodeDataFrame(const Napi::Env& env, PyObject* p_frame);
+}
+
+#endif
@@ -0,0 +1,668 @@
+#include "conversion_plan.hpp"
+#include "instance_data.hpp"
+#include "interop_helpers.hpp"
+#include "internal_helpers.h"
+#include "key_cache.hpp"
+#include "python_helpers.hpp"
+#include "release_queue.hpp"
+#include "type_helpers.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * The maximum nesting of a declared shape, which also stops cyclic shapes.
+ */
+#define MAX_PLAN_DEPTH 64
+
+/**
+ * The number of compiled plans kept per environment before the cache is cleared.
+ */
+#define MAX_CACHED_PLANS 256
+
+Napi::FunctionReference NPI::ConversionPlan::m_constructor;
+
+namespace NPI
+{
+    enum class PlanKind
+    {
+        Any,
+        Bool,
+        Float64,
+        Int32,
+        Int64,
+        String,
+        List,
+        Record,
+    };
+
+    struct PlanField;
+
+    struct PlanNode
+    {
+        PlanKind kind = PlanKind::Any;
+
+        /**
+         * Whether `None` and `undefined` are accepted in place of the value.
+         */
+        bool optional = false;
+
+        /**
+         * The plan of the elements of a list.
+         */
+        std::unique_ptr<PlanNode> element;
+
+        /**
+         * The plans of the fields of a record, in declaration order.
+         */
+        std::vector<std::unique_ptr<PlanField>> fields;
+
+        /**
+         * The names of the fields of a record as property keys, in the same order. Held through an
+         * array, since strings cannot be referenced directly without NAPI_EXPERIMENTAL.
+         */
+        Napi::ObjectReference n_names;
+    };
+
+    struct PlanField
+    {
+        std::string name;
+
+        /**
+         * The interned key of the field.
+         */
+        PyObject* p_key;
+
+        std::unique_ptr<PlanNode> node;
+
+        ~PlanField()
+        {
+            // Plans are finalized by V8, without the GIL.
+            ScheduleDecref(p_key);
+        }
+    };
+}
+
+namespace
+{
+    /**
+     * The plan handed over to the constructor call of ConversionPlan::Compile.
+     */
+    thread_local std::shared_ptr<const NPI::PlanNode> pending_plan;
+
+    thread_local bool pending_strict = false;
+
+    const char* KindName(NPI::PlanKind kind)
+    {
+        switch (kind)
+        {
+            case NPI::PlanKind::Any:     return "any";
+            case NPI::PlanKind::Bool:    return "bool";
+            case NPI::PlanKind::Float64: return "f64";
+            case NPI::PlanKind::Int32:   return "i32";
+            case NPI::PlanKind::Int64:   return "i64";
+            case NPI::PlanKind::String:  return "str";
+            case NPI::PlanKind::List:    return "list";
+            case NPI::PlanKind::Record:  return "record";
+        }
+
+        return "any";
+    }
+
+    NPI::PlanKind ParseKind(const Napi::Env& env, const std::string& name)
+    {
+        if (name == "any")                                          { return NPI::PlanKind::Any; }
+        if (name == "bool")                                         { return NPI::PlanKind::Bool; }
+        if ((name == "f64") || (name == "float") || (name == "number")) { return NPI::PlanKind::Float64; }
+        if ((name == "i32") || (name == "int32"))                   { return NPI::PlanKind::Int32; }
+        if ((name == "i64") || (name == "int64") || (name == "bigint")) { return NPI::PlanKind::Int64; }
+        if ((name == "str") || (name == "string"))                  { return NPI::PlanKind::String; }
+
+        throw Napi::TypeError::New(env, "Unknown type in schema: " + name);
+    }
+
+    /**
+     * Compile a declared shape, and append its canonical form to `canonical`.
+     */
+    std::unique_ptr<NPI::PlanNode> CompileNode(const Napi::Env& env, const Napi::Value& n_spec, std::string& canonical, size_t depth)
+    {
+        if (depth > MAX_PLAN_DEPTH)
+        {
+            throw Napi::RangeError::New(env, "The schema is nested too deeply.");
+        }
+
+        auto node = std::unique_ptr<NPI::PlanNode>(new NPI::PlanNode());
+
+        if (n_spec.IsString())
+        {
+            auto name = n_spec.As<Napi::String>().Utf8Value();
+            if (!name.empty() && (name.back() == '?'))
+            {
+                name.pop_back();
+                node->optional = true;
+            }
+
+            node->kind = ParseKind(env, name);
+
+            canonical += KindName(node->kind);
+            if (node->optional) { canonical += '?'; }
+        }
+        else if (n_spec.IsArray())
+        {
+            auto n_element = n_spec.As<Napi::Array>();
+            if (n_element.Length() != 1)
+            {
+                throw Napi::TypeError::New(env, "A list in a schema must declare exactly one element type.");
+            }
+
+            node->kind = NPI::PlanKind::List;
+
+            canonical += '[';
+            node->element = CompileNode(env, n_element.Get(0u), canonical, depth + 1);
+            canonical += ']';
+        }
+        else if (n_spec.IsObject())
+        {
+            auto n_fields = n_spec.As<Napi::Object>();
+            auto n_names  = n_fields.GetPropertyNames();
+
+            node->kind = NPI::PlanKind::Record;
+
+            auto n_keys = Napi::Array::New(env, n_names.Length());
+
+            canonical += '{';
+            for (uint32_t i = 0; i < n_names.Length(); i++)
+            {
+                auto field = std::unique_ptr<NPI::PlanField>(new NPI::PlanField());
+
+                auto n_name = n_names.Get(i).ToString();
+
+                field->name  = n_name.Utf8Value();
+                field->p_key = NPI::InternKey(field->name.data(), field->name.size());
+                if (field->p_key == NULL)
+                {
+                    NPI::ThrowPythonError(env);
+                }
+
+                n_keys.Set(i, n_name);
+
+                canonical += std::to_string(field->name.size()) + ':' + field->name + '=';
+                field->node = CompileNode(env, n_fields.Get(n_name), canonical, depth + 1);
+                canonical += ',';
+
+                node->fields.push_back(std::move(field));
+            }
+            canonical += '}';
+
+            node->n_names = Napi::Persistent(n_keys.As<Napi::Object>());
+        }
+        else
+        {
+            throw Napi::TypeError::New(env, "A schema must be made of type names, single-element arrays and objects.");
+        }
+
+        return node;
+    }
+
+    /**
+     * Take ownership of a new reference, throwing the Python error when there is none.
+     */
+    PyObject* Checked(const Napi::Env& env, PyObject* p_object)
+    {
+        if (p_object == NULL)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        return p_object;
+    }
+}
+
+Napi::Object NPI::ConversionPlan::Init(Napi::Env env, Napi::Object exports)
+{
+    auto function = DefineClass(env, STRINGIFY(ConversionPlan),
+        {
+            InstanceMethod("toNode", &ConversionPlan::ToNodeCallback),
+            InstanceMethod("toPython", &ConversionPlan::ToPythonCallback),
+            InstanceMethod("call", &ConversionPlan::CallCallback),
+            InstanceAccessor("fallbacks", &ConversionPlan::GetFallbacks, nullptr),
+        });
+
+    m_constructor = Napi::Persistent(function);
+    m_constructor.SuppressDestruct();
+
+    exports.Set("ConversionPlan", function);
+    return exports;
+}
+
+Napi::Value NPI::ConversionPlan::Compile(const Napi::Env& env, const Napi::Value& n_spec, bool strict)
+{
+    std::string canonical(strict ? "!" : "");
+    auto root = CompileNode(env, n_spec, canonical, 0);
+
+    auto& plans = GetInstanceData(env).conversion_plans;
+
+    auto found = plans.find(canonical);
+    if (found != plans.end())
+    {
+        return found->second.Value();
+    }
+
+    if (plans.size() >= MAX_CACHED_PLANS)
+    {
+        plans.clear();
+    }
+
+    pending_plan   = std::move(root);
+    pending_strict = strict;
+
+    auto plan = m_constructor.New({});
+    plans.emplace(std::move(canonical), Napi::Persistent(plan));
+
+    return plan;
+}
+
+NPI::ConversionPlan::ConversionPlan(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<ConversionPlan>(info), m_strict(pending_strict), m_fallbacks(0)
+{
+    if (!pending_plan)
+    {
+        throw Napi::TypeError::New(info.Env(), STRINGIFY(ConversionPlan) " cannot be constructed from JavaScript, use schema().");
+    }
+
+    m_root = std::move(pending_plan);
+}
+
+Napi::Value NPI::ConversionPlan::ToNode(const Napi::Env& env, PyObject* p_value)
+{
+    return ToNode(env, *m_root, p_value);
+}
+
+PyObject* NPI::ConversionPlan::ToPython(const Napi::Value& n_value)
+{
+    return ToPython(n_value.Env(), *m_root, n_value);
+}
+
+Napi::Value NPI::ConversionPlan::FallbackToNode(const Napi::Env& env, const PlanNode& node, PyObject* p_value)
+{
+    m_fallbacks++;
+
+    if (m_strict)
+    {
+        throw Napi::TypeError::New(env, std::string("Expected ") + KindName(node.kind) + ", got " + Py_TYPE(p_value)->tp_name + ".");
+    }
+
+    return ToNodeValue(env, p_value);
+}
+
+PyObject* NPI::ConversionPlan::FallbackToPython(const Napi::Env& env, const PlanNode& node, const Napi::Value& n_value)
+{
+    m_fallbacks++;
+
+    if (m_strict)
+    {
+        throw Napi::TypeError::New(env, std::string("Expected ") + KindName(node.kind) + ", got " + n_value.ToString().Utf8Value() + ".");
+    }
+
+    return ToPythonObject(n_value);
+}
+
+Napi::Value NPI::ConversionPlan::ToNode(const Napi::Env& env, const PlanNode& node, PyObject* p_value)
+{
+    if (p_value == Py_None)
+    {
+        return (node.optional || (node.kind == PlanKind::Any)) ? env.Undefined() : FallbackToNode(env, node, p_value);
+    }
+
+    switch (node.kind)
+    {
+        case PlanKind::Any:
+            return ToNodeValue(env, p_value);
+
+        case PlanKind::Bool:
+            if ((p_value == Py_True) || (p_value == Py_False))
+            {
+                return Napi::Boolean::New(env, p_value == Py_True);
+            }
+            break;
+
+        case PlanKind::Float64:
+            if (PyFloat_CheckExact(p_value))
+            {
+                return Napi::Number::New(env, PyFloat_AS_DOUBLE(p_value));
+            }
+            if (PyLong_CheckExact(p_value))
+            {
+                auto value = PyLong_AsDouble(p_value);
+                if ((value != -1.0) || !PyErr_Occurred())
+                {
+                    return Napi::Number::New(env, value);
+                }
+
+                PyErr_Clear();
+            }
+            break;
+
+        case PlanKind::Int32:
+            if (PyLong_CheckExact(p_value))
+            {
+                int  overflow;
+                auto value = PyLong_AsLongAndOverflow(p_value, &overflow);
+                if (!overflow && (value >= INT32_MIN) && (value <= INT32_MAX))
+                {
+                    return Napi::Number::New(env, static_cast<double>(value));
+                }
+            }
+            break;
+
+        case PlanKind::Int64:
+            if (PyLong_CheckExact(p_value))
+            {
+                int  overflow;
+                auto value = PyLong_AsLongLongAndOverflow(p_value, &overflow);
+                if (!overflow)
+                {
+                    return Napi::BigInt::New(env, static_cast<int64_t>(value));
+                }
+            }
+            break;
+
+        case PlanKind::String:
+            if (PyUnicode_CheckExact(p_value))
+            {
+                Py_ssize_t length;
+                auto data = PyUnicode_AsUTF8AndSize(p_value, &length);
+                if (data == NULL)
+                {
+                    ThrowPythonError(env);
+                }
+
+                return Napi::String::New(env, data, length);
+            }
+            break;
+
+        case PlanKind::List:
+            if (PyList_CheckExact(p_value) || PyTuple_CheckExact(p_value))
+            {
+                auto length  = PySequence_Fast_GET_SIZE(p_value);
+                auto n_array = Napi::Array::New(env, length);
+
+                for (Py_ssize_t i = 0; i < length; i++)
+                {
+                    n_array.Set(static_cast<uint32_t>(i), ToNode(env, *node.element, PySequence_Fast_GET_ITEM(p_value, i)));
+                }
+
+                return n_array;
+            }
+            break;
+
+        case PlanKind::Record:
+        {
+            // Dicts are read by key, any other object (dataclasses, named tuples...) by attribute.
+            auto is_dict = PyDict_CheckExact(p_value);
+            if (!is_dict && (PyLong_Check(p_value) || PyFloat_Check(p_value) || PyUnicode_Check(p_value) || PyList_Check(p_value)))
+            {
+                break;
+            }
+
+            PythonReferences attributes;
+            std::vector<napi_property_descriptor> descriptors(node.fields.size());
+
+            auto n_names = node.n_names.Value();
+
+            for (size_t i = 0; i < node.fields.size(); i++)
+            {
+                auto& field = *node.fields[i];
+
+                PyObject* p_field;
+                if (is_dict)
+                {
+                    p_field = PyDict_GetItemWithError(p_value, field.p_key);
+                }
+                else
+                {
+                    p_field = attributes.Push(PyObject_GetAttr(p_value, field.p_key));
+                    if ((p_field == NULL) && PyErr_ExceptionMatches(PyExc_AttributeError))
+                    {
+                        PyErr_Clear();
+                    }
+                }
+
+                if ((p_field == NULL) && PyErr_Occurred())
+                {
+                    ThrowPythonError(env);
+                }
+
+                Napi::Value n_field;
+                if (p_field != NULL)
+                {
+                    n_field = ToNode(env, *field.node, p_field);
+                }
+                else if (field.node->optional)
+                {
+                    n_field = env.Undefined();
+                }
+                else
+                {
+                    m_fallbacks++;
+                    if (m_strict)
+                    {
+                        throw Napi::TypeError::New(env, "Missing field " + field.name + ".");
+                    }
+
+                    n_field = env.Undefined();
+                }
+
+                descriptors[i].name       = n_names.Get(static_cast<uint32_t>(i));
+                descriptors[i].value      = n_field;
+                descriptors[i].attributes = static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+            }
+
+            auto n_object = Napi::Object::New(env);
+            if (napi_define_properties(env, n_object, descriptors.size(), descriptors.data()) != napi_ok)
+            {
+                throw Napi::Error::New(env);
+            }
+
+            return n_object;
+        }
+    }
+
+    return FallbackToNode(env, node, p_value);
+}
+
+PyObject* NPI::ConversionPlan::ToPython(const Napi::Env& env, const PlanNode& node, const Napi::Value& n_value)
+{
+    if (n_value.IsUndefined() || n_value.IsNull())
+    {
+        if (node.optional || (node.kind == PlanKind::Any))
+        {
+            Py_INCREF(Py_None);
+            return Py_None;
+        }
+
+        return FallbackToPython(env, node, n_value);
+    }
+
+    switch (node.kind)
+    {
+        case PlanKind::Any:
+            return ToPythonObject(n_value);
+
+        case PlanKind::Bool:
+            if (n_value.IsBoolean())
+            {
+                return PyBool_FromLong(n_value.As<Napi::Boolean>().Value());
+            }
+            break;
+
+        case PlanKind::Float64:
+            if (n_value.IsNumber())
+            {
+                return Checked(env, PyFloat_FromDouble(n_value.As<Napi::Number>().DoubleValue()));
+            }
+            break;
+
+        case PlanKind::Int32:
+            if (n_value.IsNumber())
+            {
+                auto value = n_value.As<Napi::Number>().DoubleValue();
+                if ((value >= INT32_MIN) && (value <= INT32_MAX) && (value == static_cast<int32_t>(value)))
+                {
+                    return Checked(env, PyLong_FromLong(static_cast<int32_t>(value)));
+                }
+            }
+            break;
+
+        case PlanKind::Int64:
+            if (n_value.IsBigInt())
+            {
+                bool lossless;
+                auto value = n_value.As<Napi::BigInt>().Int64Value(&lossless);
+                if (lossless)
+                {
+                    return Checked(env, PyLong_FromLongLong(value));
+                }
+            }
+            else if (n_value.IsNumber())
+            {
+                auto value = n_value.As<Napi::Number>().DoubleValue();
+                if ((value >= -9007199254740991.0) && (value <= 9007199254740991.0) && (value == static_cast<int64_t>(value)))
+                {
+                    return Checked(env, PyLong_FromLongLong(static_cast<int64_t>(value)));
+                }
+            }
+            break;
+
+        case PlanKind::String:
+            if (n_value.IsString())
+            {
+                auto value = n_value.As<Napi::String>().Utf8Value();
+                return Checked(env, PyUnicode_FromStringAndSize(value.data(), value.size()));
+            }
+            break;
+
+        case PlanKind::List:
+            if (n_value.IsArray())
+            {
+                auto n_array = n_value.As<Napi::Array>();
+                auto length  = n_array.Length();
+                auto p_list  = Checked(env, PyList_New(length));
+
+                try
+                {
+                    for (uint32_t i = 0; i < length; i++)
+                    {
+                        PyList_SET_ITEM(p_list, i, ToPython(env, *node.element, n_array.Get(i)));
+                    }
+                }
+                catch (...)
+                {
+                    Py_DECREF(p_list);
+                    throw;
+                }
+
+                return p_list;
+            }
+            break;
+
+        case PlanKind::Record:
+            if (n_value.IsObject() && !n_value.IsArray() && !n_value.IsFunction())
+            {
+                auto n_object = n_value.As<Napi::Object>();
+                auto n_names  = node.n_names.Value();
+                auto p_dict   = Checked(env, _PyDict_NewPresized(node.fields.size()));
+
+                try
+                {
+                    for (size_t i = 0; i < node.fields.size(); i++)
+                    {
+                        auto& field  = node.fields[i];
+                        auto n_field = n_object.Get(n_names.Get(static_cast<uint32_t>(i)));
+                        if (n_field.IsUndefined() && field->node->optional)
+                        {
+                            continue;
+                        }
+
+                        auto p_field = ToPython(env, *field->node, n_field);
+                        auto status  = PyDict_SetItem(p_dict, field->p_key, p_field);
+                        Py_DECREF(p_field);
+
+                        if (status < 0)
+                        {
+                            ThrowPythonError(env);
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    Py_DECREF(p_dict);
+                    throw;
+                }
+
+                return p_dict;
+            }
+            break;
+    }
+
+    return FallbackToPython(env, node, n_value);
+}
+
+Napi::Value NPI::ConversionPlan::ToNodeCallback(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Convert);
+        PythonReferences python_args;
+
+        auto python_value = python_args.Push(ToPythonObject(info[0]));
+
+        return ToNode(env, python_value);
+    }
+}
+
+Napi::Value NPI::ConversionPlan::ToPythonCallback(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Convert);
+        PythonReferences python_args;
+
+        auto python_value = python_args.Push(ToPython(info[0]));
+
+        return ToNodeResult(env, python_value);
+    }
+}
+
+Napi::Value NPI::ConversionPlan::CallCallback(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+        PythonReferences python_args;
+
+        auto python_target = python_args.Push(ToPythonObject(info[0]));
+
+        PyObject* python_kwnames;
+        auto positional = ToPythonArguments(info, 1, python_args, python_kwnames);
+
+        auto python_return = python_args.Push(PyObject_Vectorcall(python_target, python_args.Data() + 1, positional, python_kwnames));
+        if (python_return == NULL)
+        {
+            ThrowPythonError(env);
+        }
+
+        return ToNode(env, python_return);
+    }
+}
+
+Napi::Value NPI::ConversionPlan::GetFallbacks(const Napi::CallbackInfo& info)
+{
+    return Napi::Number::New(info.Env(), static_cast<double>(m_fallbacks));
+}
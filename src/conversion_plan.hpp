@@ -0,0 +1,72 @@
+#ifndef NPI_CONVERSION_PLAN_HPP
+#define NPI_CONVERSION_PLAN_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace NPI
+{
+    struct PlanNode;
+
+    /**
+     * A conversion compiled from a declared shape, such as `{ id: "i64", name: "str", tags: ["str"] }`.
+     *
+     * Values are converted by the shape without probing their types. A value that does not match
+     * its part of the shape falls back to the dynamic conversion, or throws a TypeError when the
+     * plan is strict.
+     */
+    class ConversionPlan : public Napi::ObjectWrap<ConversionPlan>
+    {
+        public:
+            static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+            /**
+             * Compile a shape into a plan, reusing the cached plan of an equal shape.
+             */
+            static Napi::Value Compile(const Napi::Env& env, const Napi::Value& n_spec, bool strict);
+
+            /**
+             * Convert a Python value by the plan. The caller must hold the GIL.
+             */
+            Napi::Value ToNode(const Napi::Env& env, PyObject* p_value);
+
+            /**
+             * Convert a Node value by the plan. The caller must hold the GIL.
+             *
+             * @return A new reference.
+             */
+            PyObject* ToPython(const Napi::Value& n_value);
+
+            ConversionPlan(const Napi::CallbackInfo& info);
+
+        private:
+            Napi::Value ToNode(const Napi::Env& env, const PlanNode& node, PyObject* p_value);
+
+            PyObject* ToPython(const Napi::Env& env, const PlanNode& node, const Napi::Value& n_value);
+
+            Napi::Value FallbackToNode(const Napi::Env& env, const PlanNode& node, PyObject* p_value);
+
+            PyObject* FallbackToPython(const Napi::Env& env, const PlanNode& node, const Napi::Value& n_value);
+
+            Napi::Value ToNodeCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value ToPythonCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value CallCallback(const Napi::CallbackInfo& info);
+
+            Napi::Value GetFallbacks(const Napi::CallbackInfo& info);
+
+            static Napi::FunctionReference m_constructor;
+
+            std::shared_ptr<const PlanNode> m_root;
+
+            bool m_strict;
+
+            uint64_t m_fallbacks;
+    };
+};
+
+#endif
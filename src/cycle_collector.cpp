@@ -0,0 +1,289 @@
+#include "cycle_collector.hpp"
+#include "instance_data.hpp"
+#include "node_wrapper.h"
+#include "python_wrapper.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct CycleProbe
+    {
+        std::thread::id thread;
+
+        /**
+         * The demoted objects, kept alive until the probe ends.
+         */
+        std::vector<PyObject*> demoted;
+
+        /**
+         * A `WeakMap` from wrappers to the Node values they reach through Python.
+         */
+        Napi::ObjectReference mirrors;
+    };
+
+    std::unique_ptr<CycleProbe> active_probe;
+    std::atomic<bool>           probe_active { false };
+
+    /**
+     * The number of holds taken by work that runs Python off the thread of the environment.
+     */
+    std::atomic<size_t> probe_holds { 0 };
+
+    uint64_t probes_total    = 0;
+    uint64_t demoted_total   = 0;
+    uint64_t restored_total  = 0;
+    uint64_t collected_total = 0;
+
+    int CollectReferent(PyObject* object, void* arg)
+    {
+        static_cast<std::vector<PyObject*>*>(arg)->push_back(object);
+        return 0;
+    }
+
+    /**
+     * The subgraph of the Python heap reachable from the objects held by wrappers.
+     */
+    struct HeldGraph
+    {
+        std::unordered_map<PyObject*, size_t> index;
+
+        std::vector<PyObject*>           nodes;
+        std::vector<std::vector<size_t>> edges;
+        std::vector<Py_ssize_t>          holds;
+
+        std::vector<std::vector<NPI::WrappedPythonObject*>> holders;
+
+        size_t Intern(PyObject* object)
+        {
+            auto found = index.find(object);
+            if (found != index.end()) { return found->second; }
+
+            auto i = nodes.size();
+            index.emplace(object, i);
+            nodes.push_back(object);
+            edges.emplace_back();
+            holds.push_back(0);
+            holders.emplace_back();
+
+            return i;
+        }
+    };
+}
+
+size_t NPI::BeginCycleProbe(const Napi::Env& env)
+{
+    EndCycleProbe();
+
+    if (probe_holds.load(std::memory_order_acquire) > 0) { return 0; }
+
+    HeldGraph graph;
+
+    for (auto& entry : GetInstanceData(env).python_wrappers)
+    {
+        auto i = graph.Intern(entry.first);
+        graph.holds[i]++;
+        graph.holders[i].push_back(entry.second);
+    }
+
+    auto roots = graph.nodes.size();
+
+    std::vector<PyObject*> referents;
+    for (size_t i = 0; i < graph.nodes.size(); i++)
+    {
+        auto object = graph.nodes[i];
+        if (!PyObject_IS_GC(object) || (Py_TYPE(object)->tp_traverse == NULL)) { continue; }
+
+        referents.clear();
+        Py_TYPE(object)->tp_traverse(object, CollectReferent, &referents);
+
+        for (auto referent : referents)
+        {
+            auto j = graph.Intern(referent);
+            graph.edges[i].push_back(j);
+        }
+    }
+
+    auto count = graph.nodes.size();
+
+    // Like the Python collector, an object whose reference count is not explained by the edges of
+    // the subgraph and the wrappers is referenced from elsewhere, and so is everything it reaches.
+    std::vector<Py_ssize_t> internal(count, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        for (auto j : graph.edges[i]) { internal[j]++; }
+    }
+
+    std::vector<char>   rooted(count, 0);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < count; i++)
+    {
+        if ((Py_REFCNT(graph.nodes[i]) - internal[i] - graph.holds[i]) > 0)
+        {
+            rooted[i] = 1;
+            pending.push_back(i);
+        }
+    }
+
+    while (!pending.empty())
+    {
+        auto i = pending.back();
+        pending.pop_back();
+
+        for (auto j : graph.edges[i])
+        {
+            if (!rooted[j])
+            {
+                rooted[j] = 1;
+                pending.push_back(j);
+            }
+        }
+    }
+
+    std::vector<char> candidate(count, 0);
+    bool has_candidates = false;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto object = graph.nodes[i];
+        if (rooted[i] || !NPI_WrappedNodeObject_Check(object)) { continue; }
+        if (NPI_WrappedNodeObject_GetNodeEnv(object) != static_cast<napi_env>(env)) { continue; }
+        if (NPI_WrappedNodeObject_GetNodeValue(object) == NULL) { continue; }
+
+        candidate[i]   = 1;
+        has_candidates = true;
+    }
+
+    if (!has_candidates) { return 0; }
+
+    auto probe    = std::unique_ptr<CycleProbe>(new CycleProbe());
+    probe->thread = std::this_thread::get_id();
+
+    auto mirrors = env.Global().Get("WeakMap").As<Napi::Function>().New({});
+    auto set     = mirrors.Get("set").As<Napi::Function>();
+    probe->mirrors = Napi::Persistent(mirrors);
+
+    // Mirror every path from a wrapper to a candidate that does not pass through a rooted object.
+    std::vector<char>   visited(count, 0);
+    std::vector<size_t> reached;
+    for (size_t root = 0; root < roots; root++)
+    {
+        if (rooted[root]) { continue; }
+
+        std::fill(visited.begin(), visited.end(), 0);
+        reached.clear();
+
+        visited[root] = 1;
+        pending.push_back(root);
+        while (!pending.empty())
+        {
+            auto i = pending.back();
+            pending.pop_back();
+
+            if (candidate[i]) { reached.push_back(i); }
+
+            for (auto j : graph.edges[i])
+            {
+                if (!rooted[j] && !visited[j])
+                {
+                    visited[j] = 1;
+                    pending.push_back(j);
+                }
+            }
+        }
+
+        if (reached.empty()) { continue; }
+
+        auto targets = Napi::Array::New(env, reached.size());
+        for (uint32_t k = 0; k < reached.size(); k++)
+        {
+            targets.Set(k, Napi::Value(env, NPI_WrappedNodeObject_GetNodeValue(graph.nodes[reached[k]])));
+        }
+
+        for (auto wrapper : graph.holders[root])
+        {
+            auto wrapper_value = wrapper->NodeValue();
+            if (wrapper_value.IsEmpty()) { continue; }
+
+            set.Call(mirrors, { wrapper_value, targets });
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!candidate[i] || !NPI_WrappedNodeObject_Demote(graph.nodes[i])) { continue; }
+
+        Py_INCREF(graph.nodes[i]);
+        probe->demoted.push_back(graph.nodes[i]);
+    }
+
+    auto demoted = probe->demoted.size();
+
+    probes_total++;
+    demoted_total += demoted;
+
+    active_probe = std::move(probe);
+    probe_active.store(true, std::memory_order_release);
+
+    return demoted;
+}
+
+size_t NPI::EndCycleProbe()
+{
+    if (!probe_active.load(std::memory_order_acquire)) { return 0; }
+
+    // Only the thread of the environment may touch the references.
+    if (active_probe->thread != std::this_thread::get_id()) { return 0; }
+
+    auto probe = std::move(active_probe);
+    probe_active.store(false, std::memory_order_release);
+
+    size_t collected = 0;
+    for (auto object : probe->demoted)
+    {
+        if (NPI_WrappedNodeObject_Promote(object))
+        {
+            restored_total++;
+        }
+        else
+        {
+            collected++;
+        }
+
+        Py_DECREF(object);
+    }
+
+    collected_total += collected;
+    return collected;
+}
+
+void NPI::HoldCycleProbes()
+{
+    probe_holds.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void NPI::ReleaseCycleProbes()
+{
+    probe_holds.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool NPI::IsCycleProbeActive()
+{
+    return probe_active.load(std::memory_order_relaxed);
+}
+
+NPI::CycleCollectorStats NPI::GetCycleCollectorStats()
+{
+    return CycleCollectorStats
+    {
+        probes_total,
+        demoted_total,
+        restored_total,
+        collected_total,
+        IsCycleProbeActive(),
+    };
+}
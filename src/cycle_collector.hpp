@@ -0,0 +1,61 @@
+#ifndef NPI_CYCLE_COLLECTOR_HPP
+#define NPI_CYCLE_COLLECTOR_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace NPI
+{
+    /**
+     * A snapshot of the cycle collector counters.
+     */
+    struct CycleCollectorStats
+    {
+        uint64_t probes;
+        uint64_t demoted;
+        uint64_t restored;
+        uint64_t collected;
+        bool     probing;
+    };
+
+    /**
+     * Start a cycle probe.
+     *
+     * The Python objects held by wrappers are traversed to find every `WrappedNodeObject` that is
+     * only reachable from those wrappers. The references of such objects are demoted to weak ones,
+     * while each path from a wrapper to the Node value it reaches through Python is mirrored by an
+     * ephemeron edge in the V8 heap. V8 then sees the cross-heap graph as a whole, and collects the
+     * cycles that no root can reach.
+     *
+     * No Python code may run while a probe is active, so the probe is ended by the next bridge
+     * entry. The caller must hold the GIL and run on the thread of the environment.
+     *
+     * @return The number of demoted references.
+     */
+    size_t BeginCycleProbe(const Napi::Env&);
+
+    /**
+     * End the active probe, if any, promoting the surviving references back to strong ones. The
+     * caller must hold the GIL.
+     *
+     * @return The number of references whose Node value was collected.
+     */
+    size_t EndCycleProbe();
+
+    /**
+     * Prevent new probes while Python may run on another thread, e.g. for asynchronous calls. The
+     * caller must have ended any active probe, which entering the bridge does.
+     */
+    void HoldCycleProbes();
+
+    void ReleaseCycleProbes();
+
+    bool IsCycleProbeActive();
+
+    CycleCollectorStats GetCycleCollectorStats();
+}
+
+#endif
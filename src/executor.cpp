@@ -0,0 +1,675 @@
+#include "executor.hpp"
+#include "cycle_collector.hpp"
+#include "gil.hpp"
+#include "instance_data.hpp"
+#include "interop_helpers.hpp"
+#include "node_callback.hpp"
+#include "release_queue.hpp"
+#include "type_helpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * The number of calls that can wait in the queue of the executor, a power of two.
+ */
+#define EXECUTOR_QUEUE_CAPACITY 1024
+
+/**
+ * The largest number of calls settled by a single completion.
+ */
+#define MAX_EXECUTOR_BATCH 64
+
+namespace NPI
+{
+    enum class TaskState
+    {
+        /**
+         * Waiting for the limit of its tag, on the thread of the environment.
+         */
+        Waiting,
+        Queued,
+        Running,
+        Cancelled,
+        Done,
+    };
+
+    struct ExecutorTask
+    {
+        uint64_t id = 0;
+
+        /**
+         * The callable followed by the arguments, released once the call is done.
+         */
+        std::vector<PyObject*> args;
+
+        PyObject* kwnames = NULL;
+
+        size_t positional = 0;
+
+        ExecutorOptions options;
+
+        /**
+         * Changed from `Queued` either to `Running` by the executor or to `Cancelled` by `cancel`.
+         */
+        std::atomic<TaskState> state { TaskState::Waiting };
+
+        napi_deferred deferred = nullptr;
+
+        PyObject* result = NULL;
+
+        PythonErrorInfo error;
+    };
+
+    /**
+     * A bounded multi-producer single-consumer queue of tasks, after Dmitry Vyukov's bounded queue:
+     * every cell has a sequence number that tells whether it is free for the producer of a position
+     * or ready for the consumer.
+     */
+    class ExecutorQueue
+    {
+        public:
+            ExecutorQueue() : m_cells(new Cell[EXECUTOR_QUEUE_CAPACITY]), m_tail(0), m_head(0)
+            {
+                for (size_t i = 0; i < EXECUTOR_QUEUE_CAPACITY; i++)
+                {
+                    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * @return Whether the task was queued, `false` when the queue is full.
+             */
+            bool TryPush(ExecutorTask* task)
+            {
+                auto position = m_tail.load(std::memory_order_relaxed);
+                while (true)
+                {
+                    auto& cell     = m_cells[position & (EXECUTOR_QUEUE_CAPACITY - 1)];
+                    auto sequence  = cell.sequence.load(std::memory_order_acquire);
+                    auto distance  = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+                    if (distance == 0)
+                    {
+                        if (m_tail.compare_exchange_weak(position, position + 1))
+                        {
+                            cell.task = task;
+                            cell.sequence.store(position + 1, std::memory_order_release);
+
+                            return true;
+                        }
+                    }
+                    else if (distance < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = m_tail.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            /**
+             * Take the oldest task. Only the executor thread may call it.
+             */
+            ExecutorTask* TryPop()
+            {
+                auto position = m_head.load(std::memory_order_relaxed);
+                auto& cell    = m_cells[position & (EXECUTOR_QUEUE_CAPACITY - 1)];
+                auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+                if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0)
+                {
+                    return nullptr;
+                }
+
+                auto task = cell.task;
+                cell.sequence.store(position + EXECUTOR_QUEUE_CAPACITY, std::memory_order_release);
+                m_head.store(position + 1, std::memory_order_relaxed);
+
+                return task;
+            }
+
+            /**
+             * Whether no task was pushed since the last pop. Sequentially consistent, to pair with
+             * the sleeping flag of the executor.
+             */
+            bool Empty() const
+            {
+                return m_tail.load() == m_head.load();
+            }
+
+            size_t Size() const
+            {
+                return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+            }
+
+        private:
+            struct Cell
+            {
+                std::atomic<size_t> sequence;
+                ExecutorTask*       task;
+            };
+
+            std::unique_ptr<Cell[]> m_cells;
+
+            alignas(64) std::atomic<size_t> m_tail;
+
+            alignas(64) std::atomic<size_t> m_head;
+    };
+}
+
+namespace
+{
+    using Batch = std::vector<NPI::ExecutorTask*>;
+
+    /**
+     * The order of the ready heap: the highest priority first, then the first submitted.
+     */
+    bool RunsAfter(const NPI::ExecutorTask* left, const NPI::ExecutorTask* right)
+    {
+        if (left->options.priority != right->options.priority)
+        {
+            return left->options.priority < right->options.priority;
+        }
+
+        return left->id > right->id;
+    }
+
+    /**
+     * Release the arguments of a call. The caller must hold the GIL.
+     */
+    void ReleaseArguments(NPI::ExecutorTask* task)
+    {
+        for (auto p_arg : task->args)
+        {
+            Py_DECREF(p_arg);
+        }
+
+        task->args.clear();
+    }
+
+    /**
+     * Release the references of a call that will never be settled. The caller must hold the GIL.
+     */
+    void DiscardTask(NPI::ExecutorTask* task)
+    {
+        ReleaseArguments(task);
+
+        Py_XDECREF(task->result);
+        delete task;
+    }
+}
+
+NPI::ExecutorOptions NPI::ParseExecutorOptions(const Napi::Value& n_options)
+{
+    ExecutorOptions options;
+
+    if (!n_options.IsObject())
+    {
+        return options;
+    }
+
+    auto n_object = n_options.As<Napi::Object>();
+
+    auto n_priority = n_object.Get("priority");
+    if (n_priority.IsNumber())
+    {
+        options.priority = n_priority.As<Napi::Number>().Int32Value();
+    }
+
+    auto timeout_ms = ParseTimeout(n_options);
+    if (timeout_ms >= 0)
+    {
+        options.has_deadline = true;
+        options.deadline     = DeadlineAfter(timeout_ms);
+    }
+
+    auto n_tag = n_object.Get("tag");
+    if (n_tag.IsString())
+    {
+        options.tag = n_tag.As<Napi::String>().Utf8Value();
+    }
+
+    return options;
+}
+
+NPI::PythonExecutor::PythonExecutor(const Napi::Env& env) :
+    m_env(env),
+    m_completions(nullptr),
+    m_queue(new ExecutorQueue()),
+    m_sleeping(false),
+    m_stopping(false),
+    m_last_id(0),
+    m_submitted(0),
+    m_completed(0),
+    m_rejected(0),
+    m_cancelled(0),
+    m_expired(0),
+    m_interrupted(0),
+    m_batches(0)
+{
+    napi_value resource_name;
+    napi_create_string_utf8(env, "npi.executor", NAPI_AUTO_LENGTH, &resource_name);
+
+    auto status = napi_create_threadsafe_function(env, nullptr, nullptr, resource_name, 0, 1,
+        this, [](napi_env, void* data, void*) { delete static_cast<PythonExecutor*>(data); },
+        this, OnComplete, &m_completions);
+    if (status != napi_ok)
+    {
+        throw Napi::Error::New(env, "Failed to create the completions of the Python executor.");
+    }
+
+    // Only outstanding calls keep the event loop alive.
+    napi_unref_threadsafe_function(env, m_completions);
+    napi_add_env_cleanup_hook(env, OnCleanup, this);
+
+    m_thread = std::thread(&PythonExecutor::Run, this);
+}
+
+NPI::PythonExecutor::~PythonExecutor()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+Napi::Value NPI::PythonExecutor::Submit(const Napi::Env& env, PythonReferences& python_args, size_t positional, PyObject* p_kwnames, const ExecutorOptions& options)
+{
+    auto task = new ExecutorTask();
+
+    napi_value n_promise;
+    if (napi_create_promise(env, &task->deferred, &n_promise) != napi_ok)
+    {
+        delete task;
+        throw Napi::Error::New(env);
+    }
+
+    task->id         = ++m_last_id;
+    task->args       = python_args.Detach();
+    task->kwnames    = p_kwnames;
+    task->positional = positional;
+    task->options    = options;
+
+    auto promise = Napi::Value(env, n_promise).As<Napi::Object>();
+    promise.Set("id", Napi::Number::New(env, static_cast<double>(task->id)));
+
+    if (m_tasks.empty())
+    {
+        napi_ref_threadsafe_function(env, m_completions);
+
+        // The arguments are out of sight of the cycle probes until the call is settled.
+        HoldCycleProbes();
+    }
+
+    m_tasks.emplace(task->id, task);
+    m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+    if (!options.tag.empty())
+    {
+        auto& tag = m_tags[options.tag];
+        if ((tag.limit > 0) && (tag.active >= tag.limit))
+        {
+            tag.waiting.push_back(task);
+            return promise;
+        }
+
+        tag.active++;
+    }
+
+    Admit(env, task);
+
+    return promise;
+}
+
+void NPI::PythonExecutor::Admit(const Napi::Env& env, ExecutorTask* task)
+{
+    task->state.store(TaskState::Queued);
+
+    if (!m_queue->TryPush(task))
+    {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+
+        task->error = { "Error", "The queue of the Python executor is full." };
+        Finish(env, task);
+
+        return;
+    }
+
+    if (m_sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wake.notify_one();
+    }
+}
+
+void NPI::PythonExecutor::Finish(const Napi::Env& env, ExecutorTask* task)
+{
+    try
+    {
+        if (task->result == NULL)
+        {
+            napi_reject_deferred(env, task->deferred, ToNodeError(env, task->error).Value());
+        }
+        else
+        {
+            napi_resolve_deferred(env, task->deferred, ToNodeResult(env, task->result));
+        }
+    }
+    catch (const Napi::Error& error)
+    {
+        napi_reject_deferred(env, task->deferred, error.Value());
+    }
+
+    auto waiting = task->state.load() == TaskState::Waiting;
+    auto tag     = std::move(task->options.tag);
+
+    m_tasks.erase(task->id);
+    DiscardTask(task);
+
+    if (!tag.empty() && !waiting)
+    {
+        auto& state = m_tags[tag];
+        state.active--;
+
+        while (!state.waiting.empty() && ((state.limit == 0) || (state.active < state.limit)))
+        {
+            auto next = state.waiting.front();
+            state.waiting.pop_front();
+
+            state.active++;
+            Admit(env, next);
+        }
+    }
+
+    if (m_tasks.empty())
+    {
+        napi_unref_threadsafe_function(env, m_completions);
+        ReleaseCycleProbes();
+    }
+}
+
+bool NPI::PythonExecutor::Cancel(const Napi::Env& env, uint64_t id)
+{
+    auto found = m_tasks.find(id);
+    if (found == m_tasks.end())
+    {
+        return false;
+    }
+
+    auto task = found->second;
+
+    if (task->state.load() == TaskState::Waiting)
+    {
+        auto& waiting = m_tags[task->options.tag].waiting;
+        waiting.erase(std::find(waiting.begin(), waiting.end(), task));
+
+        m_cancelled.fetch_add(1, std::memory_order_relaxed);
+
+        task->error = { "AbortError", "The call was cancelled." };
+        Finish(env, task);
+
+        return true;
+    }
+
+    // Settled as cancelled by the executor when it reaches the call.
+    auto expected = TaskState::Queued;
+    return task->state.compare_exchange_strong(expected, TaskState::Cancelled);
+}
+
+void NPI::PythonExecutor::SetTagLimit(const Napi::Env& env, const std::string& tag, size_t limit)
+{
+    auto& state = m_tags[tag];
+    state.limit = limit;
+
+    while (!state.waiting.empty() && ((state.limit == 0) || (state.active < state.limit)))
+    {
+        auto next = state.waiting.front();
+        state.waiting.pop_front();
+
+        state.active++;
+        Admit(env, next);
+    }
+}
+
+void NPI::PythonExecutor::Run()
+{
+    // A thread state of its own for the life of the thread, created through the GIL state API so
+    // that callees using `PyGILState_Ensure` find it.
+    auto gil_state    = PyGILState_Ensure();
+    auto thread_state = PyEval_SaveThread();
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_sleeping.store(true);
+            m_wake.wait(lock, [this]() { return m_stopping.load() || !m_queue->Empty(); });
+            m_sleeping.store(false);
+        }
+
+        auto requested = std::chrono::steady_clock::now();
+        PyEval_RestoreThread(thread_state);
+        BeginGilHold(GilEntry::Async, requested);
+
+        if (m_stopping.load())
+        {
+            // The environment is gone, so the calls left can only be dropped.
+            CollectSubmitted();
+            for (auto task : m_ready)
+            {
+                DiscardTask(task);
+            }
+
+            m_ready.clear();
+            break;
+        }
+
+        auto batch          = new Batch();
+        auto batch_priority = INT32_MIN;
+
+        while (true)
+        {
+            // Calls submitted meanwhile may overtake the ones already taken.
+            CollectSubmitted();
+            if (m_ready.empty())
+            {
+                break;
+            }
+
+            std::pop_heap(m_ready.begin(), m_ready.end(), RunsAfter);
+            auto task = m_ready.back();
+            m_ready.pop_back();
+
+            // Never hold back a result behind a call of a lower priority.
+            if (!batch->empty() && (task->options.priority < batch_priority))
+            {
+                Flush(batch);
+                batch_priority = INT32_MIN;
+            }
+
+            Execute(task);
+
+            batch->push_back(task);
+            batch_priority = std::max(batch_priority, task->options.priority);
+
+            if (batch->size() == MAX_EXECUTOR_BATCH)
+            {
+                Flush(batch);
+                batch_priority = INT32_MIN;
+            }
+        }
+
+        if (!batch->empty())
+        {
+            Flush(batch);
+        }
+
+        delete batch;
+
+        EndGilHold();
+        thread_state = PyEval_SaveThread();
+    }
+
+    PyGILState_Release(gil_state);
+}
+
+void NPI::PythonExecutor::CollectSubmitted()
+{
+    while (auto task = m_queue->TryPop())
+    {
+        m_ready.push_back(task);
+        std::push_heap(m_ready.begin(), m_ready.end(), RunsAfter);
+    }
+}
+
+void NPI::PythonExecutor::Execute(ExecutorTask* task)
+{
+    auto expected = TaskState::Queued;
+    if (!task->state.compare_exchange_strong(expected, TaskState::Running))
+    {
+        m_cancelled.fetch_add(1, std::memory_order_relaxed);
+
+        task->error = { "AbortError", "The call was cancelled." };
+        ReleaseArguments(task);
+
+        return;
+    }
+
+    const auto& options = task->options;
+    if (options.has_deadline && (std::chrono::steady_clock::now() >= options.deadline))
+    {
+        m_expired.fetch_add(1, std::memory_order_relaxed);
+
+        task->error = { "TimeoutError", "The deadline of the call passed before it started." };
+        ReleaseArguments(task);
+        task->state.store(TaskState::Done);
+
+        return;
+    }
+
+    auto watch = options.has_deadline ? ArmWatchdog(options.deadline) : 0;
+
+    task->result = PyObject_Vectorcall(task->args[0], task->args.data() + 1, task->positional, task->kwnames);
+    if (task->result == NULL)
+    {
+        task->error = FetchPythonError();
+    }
+
+    if ((watch != 0) && DisarmWatchdog(watch) && (task->result == NULL) && (task->error.name == "TimeoutError"))
+    {
+        m_interrupted.fetch_add(1, std::memory_order_relaxed);
+
+        task->error.message = "The call was interrupted at its deadline.";
+    }
+
+    ReleaseArguments(task);
+    task->state.store(TaskState::Done);
+}
+
+void NPI::PythonExecutor::Flush(Batch*& batch)
+{
+    if (napi_call_threadsafe_function(m_completions, batch, napi_tsfn_nonblocking) != napi_ok)
+    {
+        for (auto task : *batch) { DiscardTask(task); }
+        delete batch;
+    }
+    else
+    {
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    batch = new Batch();
+}
+
+void NPI::PythonExecutor::OnComplete(napi_env env, napi_value, void* context, void* data)
+{
+    std::unique_ptr<Batch> batch(static_cast<Batch*>(data));
+
+    if (env == nullptr)
+    {
+        // Aborted while the environment is torn down.
+        for (auto task : *batch)
+        {
+            ScheduleDecref(task->result);
+            delete task;
+        }
+
+        return;
+    }
+
+    auto executor = static_cast<PythonExecutor*>(context);
+
+    {
+        PythonEnsureGil _(GilEntry::Async);
+
+        for (auto task : *batch)
+        {
+            executor->Finish(env, task);
+        }
+    }
+
+    executor->m_completed.fetch_add(batch->size(), std::memory_order_relaxed);
+}
+
+void NPI::PythonExecutor::OnCleanup(void* data)
+{
+    auto executor = static_cast<PythonExecutor*>(data);
+
+    {
+        std::lock_guard<std::mutex> lock(executor->m_mutex);
+        executor->m_stopping.store(true);
+    }
+
+    executor->m_wake.notify_one();
+
+    // The running call may be waiting on a Node function, which would never run now.
+    AbortNodeCallbacks(executor->m_env);
+    executor->m_thread.join();
+
+    GetInstanceData(executor->m_env).executor = nullptr;
+
+    napi_release_threadsafe_function(executor->m_completions, napi_tsfn_abort);
+}
+
+NPI::ExecutorStats NPI::PythonExecutor::GetStats() const
+{
+    return ExecutorStats
+    {
+        true,
+        m_tasks.size(),
+        m_submitted.load(std::memory_order_relaxed),
+        m_completed.load(std::memory_order_relaxed),
+        m_rejected.load(std::memory_order_relaxed),
+        m_cancelled.load(std::memory_order_relaxed),
+        m_expired.load(std::memory_order_relaxed),
+        m_interrupted.load(std::memory_order_relaxed),
+        m_batches.load(std::memory_order_relaxed),
+    };
+}
+
+NPI::PythonExecutor& NPI::GetExecutor(const Napi::Env& env)
+{
+    auto& data = GetInstanceData(env);
+    if (data.executor == nullptr)
+    {
+        data.executor = new PythonExecutor(env);
+    }
+
+    return *data.executor;
+}
+
+NPI::ExecutorStats NPI::GetExecutorStats(const Napi::Env& env)
+{
+    auto executor = GetInstanceData(env).executor;
+    if (executor == nullptr)
+    {
+        return ExecutorStats { false, 0, 0, 0, 0, 0, 0, 0, 0 };
+    }
+
+    return executor->GetStats();
+}
@@ -0,0 +1,220 @@
+#ifndef NPI_EXECUTOR_HPP
+#define NPI_EXECUTOR_HPP
+
+#include "python_helpers.hpp"
+#include "watchdog.hpp"
+
+#include <napi.h>
+#include <Python.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NPI
+{
+    struct ExecutorTask;
+
+    class ExecutorQueue;
+
+    /**
+     * The scheduling of a submitted call.
+     */
+    struct ExecutorOptions
+    {
+        /**
+         * Calls of a higher priority run first, calls of the same priority in submission order.
+         */
+        int32_t priority = 0;
+
+        /**
+         * A call still queued past its deadline is rejected without running, and a running one is
+         * interrupted by a `TimeoutError`.
+         */
+        bool has_deadline = false;
+
+        Deadline deadline;
+
+        /**
+         * The tag of the caller, whose calls may be limited by `setTagLimit`.
+         */
+        std::string tag;
+    };
+
+    /**
+     * Parse `{ priority, timeoutMs, tag }`.
+     */
+    ExecutorOptions ParseExecutorOptions(const Napi::Value&);
+
+    /**
+     * A snapshot of the executor counters.
+     */
+    struct ExecutorStats
+    {
+        bool     running;
+        size_t   outstanding;
+        uint64_t submitted;
+        uint64_t completed;
+        uint64_t rejected;
+        uint64_t cancelled;
+        uint64_t expired;
+        uint64_t interrupted;
+        uint64_t batches;
+    };
+
+    /**
+     * A long-lived Python thread that runs the calls submitted by `callAsync` and `submit`.
+     *
+     * The thread keeps a single thread state for its whole life, so that running a call costs no
+     * `PyGILState_Ensure`. Calls are submitted through a bounded lock-free queue, and the thread
+     * runs the queued calls by priority under one GIL acquisition. Their results come back to the
+     * thread of the environment in batches, through a single threadsafe function call per batch.
+     */
+    class PythonExecutor
+    {
+        public:
+            explicit PythonExecutor(const Napi::Env& env);
+
+            ~PythonExecutor();
+
+            PythonExecutor(const PythonExecutor&) = delete;
+
+            PythonExecutor& operator=(const PythonExecutor&) = delete;
+
+            /**
+             * Submit a call, whose callable is the first of `python_args`. The caller must hold the
+             * GIL and run on the thread of the environment.
+             *
+             * @param python_args The callable and the arguments of the call, whose ownership is
+             *                    taken.
+             * @param p_kwnames The key tuple of the keyword arguments, owned by `python_args`, or
+             *                  `NULL`.
+             * @return A promise of the result, with the `id` of the call.
+             */
+            Napi::Value Submit(const Napi::Env& env, PythonReferences& python_args, size_t positional, PyObject* p_kwnames, const ExecutorOptions& options);
+
+            /**
+             * Cancel a call that did not start yet, rejecting it with an `AbortError`. The caller
+             * must hold the GIL.
+             *
+             * @return Whether the call will not run.
+             */
+            bool Cancel(const Napi::Env& env, uint64_t id);
+
+            /**
+             * Limit the number of calls of a tag that are queued or running at once, 0 for no
+             * limit. The calls past the limit wait in submission order. The caller must hold the
+             * GIL.
+             */
+            void SetTagLimit(const Napi::Env& env, const std::string& tag, size_t limit);
+
+            ExecutorStats GetStats() const;
+
+        private:
+            struct TagState
+            {
+                size_t limit  = 0;
+                size_t active = 0;
+
+                std::deque<ExecutorTask*> waiting;
+            };
+
+            /**
+             * Queue a call for the executor thread, or reject it when the queue is full.
+             */
+            void Admit(const Napi::Env& env, ExecutorTask* task);
+
+            /**
+             * Settle the promise of a call and admit the next waiting call of its tag. The caller
+             * must hold the GIL.
+             */
+            void Finish(const Napi::Env& env, ExecutorTask* task);
+
+            void Run();
+
+            /**
+             * Move the submitted calls into the ready heap. Only the executor thread may call it.
+             */
+            void CollectSubmitted();
+
+            /**
+             * Run a call, unless it was cancelled or its deadline passed. The caller must hold the
+             * GIL.
+             */
+            void Execute(ExecutorTask* task);
+
+            /**
+             * Hand a batch of completed calls over to the thread of the environment. The caller
+             * must hold the GIL.
+             */
+            void Flush(std::vector<ExecutorTask*>*& batch);
+
+            /**
+             * Settle the promises of a batch of completed calls on the thread of the environment.
+             */
+            static void OnComplete(napi_env env, napi_value, void* context, void* data);
+
+            /**
+             * Stop the thread when the environment is torn down. The executor is deleted by the
+             * finalizer of its threadsafe function.
+             */
+            static void OnCleanup(void* data);
+
+            napi_env m_env;
+
+            napi_threadsafe_function m_completions;
+
+            std::unique_ptr<ExecutorQueue> m_queue;
+
+            std::thread m_thread;
+
+            std::mutex m_mutex;
+
+            std::condition_variable m_wake;
+
+            std::atomic<bool> m_sleeping;
+
+            std::atomic<bool> m_stopping;
+
+            /**
+             * The calls taken from the queue, as a heap by priority. Only touched by the executor
+             * thread.
+             */
+            std::vector<ExecutorTask*> m_ready;
+
+            /**
+             * The calls submitted and not yet settled by id, only touched on the thread of the
+             * environment, as are the tags.
+             */
+            std::unordered_map<uint64_t, ExecutorTask*> m_tasks;
+
+            std::unordered_map<std::string, TagState> m_tags;
+
+            uint64_t m_last_id;
+
+            std::atomic<uint64_t> m_submitted;
+            std::atomic<uint64_t> m_completed;
+            std::atomic<uint64_t> m_rejected;
+            std::atomic<uint64_t> m_cancelled;
+            std::atomic<uint64_t> m_expired;
+            std::atomic<uint64_t> m_interrupted;
+            std::atomic<uint64_t> m_batches;
+    };
+
+    /**
+     * Get the executor of the environment, starting it on first use.
+     */
+    PythonExecutor& GetExecutor(const Napi::Env&);
+
+    ExecutorStats GetExecutorStats(const Napi::Env&);
+}
+
+#endif
@@ -0,0 +1,100 @@
+#include "external_memory.hpp"
+
+#include <atomic>
+
+namespace
+{
+    std::atomic<int64_t>  tracked_bytes  { 0 };
+    std::atomic<int64_t>  limit_bytes    { 0 };
+    std::atomic<int64_t>  next_hint      { 0 };
+    std::atomic<uint64_t> gc_hints_total { 0 };
+
+    /**
+     * Set when the limit was crossed, until the next check phase of the event loop asks for the
+     * collection.
+     */
+    std::atomic<bool> gc_hint_pending { false };
+}
+
+int64_t NPI::EstimateExternalSize(PyObject* p_object)
+{
+    // Only buffers are measured, which is a slot check for every other object. Objects without one
+    // are rarely large, and can be sized with a hint.
+    if (!PyObject_CheckBuffer(p_object))
+    {
+        return 0;
+    }
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(p_object, &view, PyBUF_RECORDS_RO) != 0)
+    {
+        PyErr_Clear();
+        return 0;
+    }
+
+    auto size = static_cast<int64_t>(view.len);
+    PyBuffer_Release(&view);
+
+    return size;
+}
+
+void NPI::AdjustExternalMemory(const Napi::Env& env, int64_t change)
+{
+    if (change == 0) { return; }
+
+    Napi::MemoryManagement::AdjustExternalMemory(env, change);
+
+    auto tracked = tracked_bytes.fetch_add(change, std::memory_order_relaxed) + change;
+    auto limit   = limit_bytes.load(std::memory_order_relaxed);
+    if (limit <= 0) { return; }
+
+    if (change < 0)
+    {
+        // Re-arm the hint once the total falls back under the limit.
+        if (tracked < limit) { next_hint.store(limit, std::memory_order_relaxed); }
+        return;
+    }
+
+    // Hint again only after another half of the limit has been allocated, so that a steady stream
+    // of wrappers above the limit does not collect on every allocation.
+    auto threshold = next_hint.load(std::memory_order_relaxed);
+    if ((tracked > limit) && (tracked >= threshold)
+        && next_hint.compare_exchange_strong(threshold, tracked + (limit / 2), std::memory_order_relaxed))
+    {
+        gc_hint_pending.store(true, std::memory_order_relaxed);
+    }
+}
+
+void NPI::RunPendingGarbageCollection(const Napi::Env& env)
+{
+    if (!gc_hint_pending.load(std::memory_order_relaxed) || !gc_hint_pending.exchange(false, std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Only possible when Node was started with `--expose-gc`, otherwise V8 is left to its own
+    // external memory heuristics.
+    Napi::HandleScope scope(env);
+
+    auto gc = env.Global().Get("gc");
+    if (!gc.IsFunction()) { return; }
+
+    gc_hints_total.fetch_add(1, std::memory_order_relaxed);
+    gc.As<Napi::Function>().Call({});
+}
+
+void NPI::SetExternalMemoryThreshold(int64_t limit)
+{
+    limit_bytes.store(limit, std::memory_order_relaxed);
+    next_hint.store(limit, std::memory_order_relaxed);
+}
+
+NPI::ExternalMemoryStats NPI::GetExternalMemoryStats()
+{
+    return ExternalMemoryStats
+    {
+        tracked_bytes.load(std::memory_order_relaxed),
+        limit_bytes.load(std::memory_order_relaxed),
+        gc_hints_total.load(std::memory_order_relaxed),
+    };
+}
@@ -0,0 +1,47 @@
+#ifndef NPI_EXTERNAL_MEMORY_HPP
+#define NPI_EXTERNAL_MEMORY_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <cstdint>
+
+namespace NPI
+{
+    /**
+     * A snapshot of the external memory accounting.
+     */
+    struct ExternalMemoryStats
+    {
+        int64_t  tracked;
+        int64_t  limit;
+        uint64_t gc_hints;
+    };
+
+    /**
+     * Estimate the memory held by a Python object from the length of its buffer, 0 when it exports
+     * none. The caller must hold the GIL.
+     */
+    int64_t EstimateExternalSize(PyObject*);
+
+    /**
+     * Report a change of the Python memory held by wrappers to V8, and schedule a garbage
+     * collection hint when the tracked total goes past the configured limit.
+     */
+    void AdjustExternalMemory(const Napi::Env&, int64_t change);
+
+    /**
+     * Ask V8 for the collection scheduled by AdjustExternalMemory, if any. Run from the check phase
+     * of the event loop, so that no collection happens in the middle of a conversion.
+     */
+    void RunPendingGarbageCollection(const Napi::Env&);
+
+    /**
+     * Set the tracked total above which a garbage collection is hinted. Zero disables the limit.
+     */
+    void SetExternalMemoryThreshold(int64_t);
+
+    ExternalMemoryStats GetExternalMemoryStats();
+}
+
+#endif
@@ -0,0 +1,138 @@
+#include "gil.hpp"
+
+#include <Python.h>
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * The number of yield points passed between two reads of the clock.
+ */
+#define YIELD_CHECK_PERIOD 64
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct EntryTimings
+    {
+        NPI::LatencyHistogram wait;
+        NPI::LatencyHistogram hold;
+        std::atomic<uint64_t> yields { 0 };
+    };
+
+    EntryTimings entry_timings[GIL_ENTRY_COUNT];
+
+    const char* entry_names[GIL_ENTRY_COUNT] =
+    {
+        "import",
+        "eval",
+        "getattr",
+        "call",
+        "async",
+        "callback",
+        "convert",
+        "release",
+        "other",
+    };
+
+    std::atomic<int64_t> yield_interval_ns { 0 };
+
+    /**
+     * The hold of the current thread, from the outermost bridge entry or its last yield.
+     */
+    thread_local bool hold_active = false;
+
+    thread_local NPI::GilEntry hold_entry = NPI::GilEntry::Other;
+
+    thread_local Clock::time_point hold_start;
+
+    thread_local unsigned yield_countdown = YIELD_CHECK_PERIOD;
+
+    uint64_t NanosecondsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+
+        return (elapsed > 0) ? static_cast<uint64_t>(elapsed) : 0;
+    }
+}
+
+const char* NPI::GetGilEntryName(GilEntry entry)
+{
+    return entry_names[static_cast<size_t>(entry)];
+}
+
+void NPI::BeginGilHold(GilEntry entry, Clock::time_point requested)
+{
+    hold_active = true;
+    hold_entry  = entry;
+    hold_start  = Clock::now();
+
+    entry_timings[static_cast<size_t>(entry)].wait.Record(NanosecondsBetween(requested, hold_start));
+}
+
+void NPI::EndGilHold()
+{
+    if (!hold_active) { return; }
+
+    entry_timings[static_cast<size_t>(hold_entry)].hold.Record(NanosecondsBetween(hold_start, Clock::now()));
+    hold_active = false;
+}
+
+void NPI::SetGilYieldInterval(double interval_ms)
+{
+    auto interval = (interval_ms > 0) ? std::chrono::duration<double, std::milli>(interval_ms) : std::chrono::duration<double, std::milli>(0);
+
+    yield_interval_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count(), std::memory_order_relaxed);
+}
+
+double NPI::GetGilYieldInterval()
+{
+    return static_cast<double>(yield_interval_ns.load(std::memory_order_relaxed)) / 1e6;
+}
+
+void NPI::YieldGilIfDue()
+{
+    if (!hold_active || (--yield_countdown > 0)) { return; }
+
+    yield_countdown = YIELD_CHECK_PERIOD;
+
+    auto interval = yield_interval_ns.load(std::memory_order_relaxed);
+    if (interval <= 0) { return; }
+
+    auto now = Clock::now();
+    if (now - hold_start < std::chrono::nanoseconds(interval)) { return; }
+
+    // The hold ends here, and a new one starts once the GIL is back.
+    auto& timings = entry_timings[static_cast<size_t>(hold_entry)];
+    timings.hold.Record(NanosecondsBetween(hold_start, now));
+    timings.yields.fetch_add(1, std::memory_order_relaxed);
+
+    Py_BEGIN_ALLOW_THREADS
+    Py_END_ALLOW_THREADS
+
+    hold_start = Clock::now();
+    timings.wait.Record(NanosecondsBetween(now, hold_start));
+}
+
+NPI::GilHoldStats NPI::GetGilHoldStats(GilEntry entry)
+{
+    const auto& timings = entry_timings[static_cast<size_t>(entry)];
+
+    return GilHoldStats
+    {
+        timings.wait.Summarize(),
+        timings.hold.Summarize(),
+        timings.yields.load(std::memory_order_relaxed),
+    };
+}
+
+void NPI::ResetGilStats()
+{
+    for (auto& timings : entry_timings)
+    {
+        timings.wait.Reset();
+        timings.hold.Reset();
+        timings.yields.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef NPI_GIL_HPP
+#define NPI_GIL_HPP
+
+#include "histogram.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The number of kinds of `GilEntry`.
+ */
+#define GIL_ENTRY_COUNT 9
+
+namespace NPI
+{
+    /**
+     * The kinds of bridge entries that take the GIL, which its metrics are kept by.
+     */
+    enum class GilEntry
+    {
+        Import,
+        Eval,
+        GetAttr,
+        Call,
+        Async,
+        Callback,
+        Convert,
+        Release,
+        Other,
+    };
+
+    const char* GetGilEntryName(GilEntry);
+
+    /**
+     * A snapshot of the GIL timings of an entry: how long it waited for the GIL, and how long it
+     * held it.
+     */
+    struct GilHoldStats
+    {
+        HistogramSummary wait;
+        HistogramSummary hold;
+        uint64_t yields;
+    };
+
+    /**
+     * Start timing the hold of the GIL taken by the outermost bridge entry of the thread, and
+     * record its wait since `requested`.
+     */
+    void BeginGilHold(GilEntry, std::chrono::steady_clock::time_point requested);
+
+    void EndGilHold();
+
+    /**
+     * Let long-running bridge entries hand the GIL over every `interval_ms`, so that queued
+     * asynchronous work can progress. 0 disables the yields.
+     */
+    void SetGilYieldInterval(double interval_ms);
+
+    double GetGilYieldInterval();
+
+    /**
+     * A yield point of a long-running loop. Releases the GIL for a moment when the current hold
+     * is older than the yield interval, which is only checked every few calls. The caller must
+     * hold the GIL through a bridge entry.
+     */
+    void YieldGilIfDue();
+
+    GilHoldStats GetGilHoldStats(GilEntry);
+
+    void ResetGilStats();
+}
+
+#endif
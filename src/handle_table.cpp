@@ -0,0 +1,117 @@
+#include "handle_table.hpp"
+#include "release_queue.hpp"
+
+#include <cmath>
+
+namespace
+{
+    /**
+     * Generations take the bits above the index that still fit in a safe integer.
+     */
+    constexpr uint32_t GENERATION_MASK = (1u << 21) - 1;
+
+    constexpr double INDEX_RANGE = 4294967296.0;
+}
+
+NPI::HandleTable::HandleTable()
+    : m_free_head(0), m_size(0)
+{
+}
+
+NPI::HandleTable::~HandleTable()
+{
+    // The environment may go away without holding the GIL, so defer the release.
+    for (auto& slot : m_slots)
+    {
+        if (slot.object != NULL) { ScheduleDecref(slot.object); }
+    }
+}
+
+double NPI::HandleTable::Acquire(PyObject* object)
+{
+    uint32_t index;
+    if (m_free_head != 0)
+    {
+        index       = m_free_head - 1;
+        m_free_head = m_slots[index].next_free;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back(Slot { NULL, 0, 0 });
+    }
+
+    auto& slot = m_slots[index];
+    slot.generation = (slot.generation % GENERATION_MASK) + 1;
+    slot.object     = object;
+    slot.next_free  = 0;
+
+    Py_INCREF(object);
+    m_size++;
+
+    return (static_cast<double>(slot.generation) * INDEX_RANGE) + index;
+}
+
+NPI::HandleTable::Slot* NPI::HandleTable::Find(double handle)
+{
+    if (!(handle >= INDEX_RANGE) || (std::floor(handle) != handle)) { return nullptr; }
+
+    auto generation = static_cast<uint32_t>(std::floor(handle / INDEX_RANGE));
+    auto index      = static_cast<uint64_t>(handle - (static_cast<double>(generation) * INDEX_RANGE));
+    if (index >= m_slots.size()) { return nullptr; }
+
+    auto& slot = m_slots[index];
+    if ((slot.object == NULL) || (slot.generation != generation)) { return nullptr; }
+
+    return &slot;
+}
+
+PyObject* NPI::HandleTable::Get(double handle) const
+{
+    auto slot = const_cast<HandleTable*>(this)->Find(handle);
+    return (slot != nullptr) ? slot->object : NULL;
+}
+
+bool NPI::HandleTable::Release(double handle)
+{
+    auto slot = Find(handle);
+    if (slot == nullptr) { return false; }
+
+    auto object = slot->object;
+
+    slot->object    = NULL;
+    slot->next_free = m_free_head;
+    m_free_head     = static_cast<uint32_t>(slot - m_slots.data()) + 1;
+    m_size--;
+
+    Py_DECREF(object);
+    return true;
+}
+
+size_t NPI::HandleTable::ReleaseAll()
+{
+    auto count = m_size;
+
+    // Detach the objects first, releasing one may run code that acquires new handles. The slots
+    // keep their generations, so the released handles stay stale.
+    std::vector<PyObject*> objects;
+    objects.reserve(count);
+
+    for (uint32_t index = 0; index < m_slots.size(); index++)
+    {
+        auto& slot = m_slots[index];
+        if (slot.object == NULL) { continue; }
+
+        objects.push_back(slot.object);
+
+        slot.object    = NULL;
+        slot.next_free = m_free_head;
+        m_free_head    = index + 1;
+    }
+
+    m_size = 0;
+
+    for (auto object : objects) { Py_DECREF(object); }
+
+    return count;
+}
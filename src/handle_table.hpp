@@ -0,0 +1,75 @@
+#ifndef NPI_HANDLE_TABLE_HPP
+#define NPI_HANDLE_TABLE_HPP
+
+#include <Python.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NPI
+{
+    /**
+     * A slab of Python objects addressed by integer handles.
+     *
+     * A handle packs the index of its slot with the generation of the slot, so a handle that was
+     * released is never confused with the one that reuses its slot. Handles fit in the safe integer
+     * range of JavaScript numbers.
+     */
+    class HandleTable
+    {
+        public:
+            HandleTable();
+
+            ~HandleTable();
+
+            /**
+             * Store a new reference to the object. The caller must hold the GIL.
+             */
+            double Acquire(PyObject* object);
+
+            /**
+             * Get the object of a handle, or `NULL` when the handle is not live.
+             *
+             * @return A borrowed reference.
+             */
+            PyObject* Get(double handle) const;
+
+            /**
+             * Release a handle. The caller must hold the GIL.
+             *
+             * @return Whether the handle was live.
+             */
+            bool Release(double handle);
+
+            /**
+             * Release every handle. The caller must hold the GIL.
+             *
+             * @return The number of released handles.
+             */
+            size_t ReleaseAll();
+
+            size_t Size() const { return m_size; }
+
+        private:
+            struct Slot
+            {
+                PyObject* object;
+                uint32_t  generation;
+                uint32_t  next_free;
+            };
+
+            Slot* Find(double handle);
+
+            std::vector<Slot> m_slots;
+
+            /**
+             * The index of the first free slot plus one, or zero when every slot is used.
+             */
+            uint32_t m_free_head;
+
+            size_t m_size;
+    };
+}
+
+#endif
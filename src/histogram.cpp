@@ -0,0 +1,131 @@
+#include "histogram.hpp"
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace
+{
+    /**
+     * The position of the highest set bit of a non-zero value.
+     */
+    size_t HighestBit(uint64_t value)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+
+        return index;
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+}
+
+NPI::LatencyHistogram::LatencyHistogram() : m_total(0), m_max(0)
+{
+    for (auto& count : m_counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t NPI::LatencyHistogram::IndexOf(uint64_t value)
+{
+    if (value < SUB_BUCKETS)
+    {
+        return static_cast<size_t>(value);
+    }
+
+    auto shift = HighestBit(value) - HISTOGRAM_SUB_BUCKET_BITS;
+    auto index = (shift + 1) * SUB_BUCKETS + static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+
+    return (index < BUCKETS) ? index : BUCKETS - 1;
+}
+
+uint64_t NPI::LatencyHistogram::UpperBoundOf(size_t index)
+{
+    if (index < SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    auto shift = index / SUB_BUCKETS - 1;
+    auto sub   = index % SUB_BUCKETS;
+
+    return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void NPI::LatencyHistogram::Record(uint64_t value)
+{
+    m_counts[IndexOf(value)].fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(value, std::memory_order_relaxed);
+
+    auto max = m_max.load(std::memory_order_relaxed);
+    while ((value > max) && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+NPI::HistogramSummary NPI::LatencyHistogram::Summarize() const
+{
+    HistogramSummary summary {};
+    summary.total = m_total.load(std::memory_order_relaxed);
+    summary.max   = m_max.load(std::memory_order_relaxed);
+
+    uint64_t counts[BUCKETS];
+
+    uint64_t count = 0;
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        count    += counts[i];
+    }
+
+    summary.count = count;
+    if (count == 0)
+    {
+        return summary;
+    }
+
+    struct Percentile
+    {
+        double    quantile;
+        uint64_t* value;
+    };
+
+    Percentile percentiles[] =
+    {
+        { 0.5, &summary.p50 },
+        { 0.9, &summary.p90 },
+        { 0.99, &summary.p99 },
+        { 0.999, &summary.p999 },
+    };
+
+    size_t next   = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; (i < BUCKETS) && (next < 4); i++)
+    {
+        seen += counts[i];
+
+        while ((next < 4) && (seen >= percentiles[next].quantile * count))
+        {
+            // A bucket bound may exceed the largest value recorded.
+            auto bound = UpperBoundOf(i);
+            *percentiles[next].value = (bound < summary.max) ? bound : summary.max;
+
+            next++;
+        }
+    }
+
+    return summary;
+}
+
+void NPI::LatencyHistogram::Reset()
+{
+    for (auto& count : m_counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+
+    m_total.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
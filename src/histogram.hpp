@@ -0,0 +1,77 @@
+#ifndef NPI_HISTOGRAM_HPP
+#define NPI_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The number of linear sub-buckets per power of two of a histogram, which bounds its relative
+ * error to about 6%.
+ */
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+
+/**
+ * The largest recorded value is about 2^40 ns, some 18 minutes, larger values are clamped.
+ */
+#define HISTOGRAM_MAX_BITS 40
+
+namespace NPI
+{
+    /**
+     * A summary of a histogram, in nanoseconds.
+     */
+    struct HistogramSummary
+    {
+        uint64_t count;
+        uint64_t total;
+        uint64_t max;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+    };
+
+    /**
+     * A lock-free histogram of durations in the style of HdrHistogram: buckets grow by powers of
+     * two, and each power of two is split into linear sub-buckets. Recording is a few relaxed
+     * atomic increments, so any thread may record at any time.
+     */
+    class LatencyHistogram
+    {
+        public:
+            LatencyHistogram();
+
+            void Record(uint64_t value);
+
+            /**
+             * Summarize the recorded values. Concurrent records may or may not be included.
+             */
+            HistogramSummary Summarize() const;
+
+            /**
+             * Clear the recorded values. Concurrent records may survive in part.
+             */
+            void Reset();
+
+        private:
+            static constexpr size_t SUB_BUCKETS = size_t(1) << HISTOGRAM_SUB_BUCKET_BITS;
+
+            static constexpr size_t BUCKETS = (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+            static size_t IndexOf(uint64_t value);
+
+            /**
+             * The largest value of a bucket, which percentiles report so as not to understate them.
+             */
+            static uint64_t UpperBoundOf(size_t index);
+
+            std::atomic<uint64_t> m_counts[BUCKETS];
+
+            std::atomic<uint64_t> m_total;
+
+            std::atomic<uint64_t> m_max;
+    };
+}
+
+#endif
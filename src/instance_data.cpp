@@ -0,0 +1,28 @@
+#include "instance_data.hpp"
+
+void NPI::InitInstanceData(const Napi::Env& env)
+{
+    auto data = new InstanceData();
+
+    auto weak_map = env.Global().Get("WeakMap").As<Napi::Function>();
+    auto wrappers = weak_map.New({});
+
+    data->node_wrappers        = Napi::Persistent(wrappers);
+    data->node_wrappers_get    = Napi::Persistent(wrappers.Get("get").As<Napi::Function>());
+    data->node_wrappers_set    = Napi::Persistent(wrappers.Get("set").As<Napi::Function>());
+    data->node_wrappers_delete = Napi::Persistent(wrappers.Get("delete").As<Napi::Function>());
+
+    data->object_prototype = Napi::Persistent(env.Global().Get("Object").ToObject().Get("prototype").ToObject());
+
+    auto map = env.Global().Get("Map").As<Napi::Function>();
+
+    data->map_constructor = Napi::Persistent(map);
+    data->map_set         = Napi::Persistent(map.Get("prototype").ToObject().Get("set").As<Napi::Function>());
+
+    Napi::Env(env).SetInstanceData(data);
+}
+
+NPI::InstanceData& NPI::GetInstanceData(const Napi::Env& env)
+{
+    return *Napi::Env(env).GetInstanceData<InstanceData>();
+}
@@ -0,0 +1,108 @@
+#ifndef NPI_INSTANCE_DATA_HPP
+#define NPI_INSTANCE_DATA_HPP
+
+#include "handle_table.hpp"
+
+#include <napi.h>
+#include <Python.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace NPI
+{
+    class WrappedPythonObject;
+
+    class PythonExecutor;
+
+    /**
+     * When dicts are converted into a `Map` instead of a plain object.
+     */
+    enum class MapOutput
+    {
+        /**
+         * Dicts with non-string keys stay wrapped.
+         */
+        Never,
+
+        /**
+         * Dicts with non-string keys become a `Map`.
+         */
+        NonStringKeys,
+
+        /**
+         * Every dict becomes a `Map`.
+         */
+        Always,
+    };
+
+    /**
+     * The state of the addon that belongs to a single Node environment.
+     */
+    struct InstanceData
+    {
+        /**
+         * Live wrappers by the Python object they wrap, so that the same object is always wrapped
+         * by the same JavaScript object.
+         */
+        std::unordered_map<PyObject*, WrappedPythonObject*> python_wrappers;
+
+        /**
+         * A `WeakMap` from Node values to an external pointing to their `WrappedNodeObject`.
+         */
+        Napi::ObjectReference node_wrappers;
+
+        Napi::FunctionReference node_wrappers_get;
+        Napi::FunctionReference node_wrappers_set;
+        Napi::FunctionReference node_wrappers_delete;
+
+        /**
+         * `Object.prototype`, to tell plain objects apart from class instances.
+         */
+        Napi::ObjectReference object_prototype;
+
+        Napi::FunctionReference map_constructor;
+
+        Napi::FunctionReference map_set;
+
+        MapOutput map_output = MapOutput::Never;
+
+        /**
+         * Whether objects that implement the Arrow PyCapsule interface convert into Arrow
+         * descriptions instead of being wrapped.
+         */
+        bool arrow_output = false;
+
+        /**
+         * Whether read-only Python memory is shared with Node as is, instead of being copied. Node
+         * cannot write-protect an ArrayBuffer, so the caller promises not to write into it.
+         */
+        bool share_readonly = false;
+
+        /**
+         * Whether the results of `import`, `getattr` and `call` are returned as handles.
+         */
+        bool handle_mode = false;
+
+        /**
+         * Compiled conversion plans by the canonical form of their shape.
+         */
+        std::unordered_map<std::string, Napi::ObjectReference> conversion_plans;
+
+        HandleTable handles;
+
+        /**
+         * The Python executor thread, started by the first `callAsync`.
+         */
+        PythonExecutor* executor = nullptr;
+    };
+
+    /**
+     * Create the state of the addon for the environment.
+     */
+    void InitInstanceData(const Napi::Env&);
+
+    InstanceData& GetInstanceData(const Napi::Env&);
+}
+
+#endif
@@ -1,4 +1,7 @@
 #include "interop_helpers.hpp"
+#include "key_cache.hpp"
+#include "python_helpers.hpp"
+#include "type_helpers.hpp"
 
 void NPI::EnsurePythonInitialized(const Napi::Env& env)
 {
@@ -7,3 +10,165 @@ void NPI::EnsurePythonInitialized(const Napi::Env& env)
         throw Napi::Error::New(env, "The Python interpreter was not initialized.");
     }
 }
+
+NPI::PythonErrorInfo NPI::FetchPythonError()
+{
+    PyObject* error_type;
+    PyObject* error_value;
+    PyObject* error_trace;
+
+    PyErr_Fetch(&error_type, &error_value, &error_trace);
+    PyErr_NormalizeException(&error_type, &error_value, &error_trace);
+
+    PythonErrorInfo info;
+
+    auto error_message = (error_value != NULL) ? PyObject_Str(error_value) : NULL;
+    auto message       = (error_message != NULL) ? PyUnicode_AsUTF8(error_message) : NULL;
+    if (message != NULL)
+    {
+        info.message = message;
+    }
+
+    if (error_type != NULL)
+    {
+        info.name = ((PyTypeObject*) error_type)->tp_name;
+    }
+
+    if (message == NULL) { PyErr_Clear(); }
+
+    Py_XDECREF(error_message);
+    Py_XDECREF(error_type);
+    Py_XDECREF(error_value);
+    Py_XDECREF(error_trace);
+
+    return info;
+}
+
+Napi::Error NPI::ToNodeError(const Napi::Env& env, const PythonErrorInfo& info)
+{
+    auto error = Napi::Error::New(env, info.message);
+    if (!info.name.empty())
+    {
+        error.Set("name", info.name);
+    }
+
+    return error;
+}
+
+void NPI::ThrowPythonError(const Napi::Env& env)
+{
+    throw ToNodeError(env, FetchPythonError());
+}
+
+void NPI::ThrowPythonError(const Napi::Env& env, WatchdogScope& watch)
+{
+    auto info = FetchPythonError();
+
+    if (watch.Disarm() && (info.name == "TimeoutError"))
+    {
+        info.message = DescribeTimeout(watch.TimeoutMs());
+    }
+
+    throw ToNodeError(env, info);
+}
+
+namespace
+{
+    /**
+     * The conversion of ToPythonArguments, over `count` values read by `get`.
+     */
+    template <typename Getter>
+    size_t ConvertArguments(const Napi::Env& env, size_t count, Getter get, NPI::PythonReferences& python_args, PyObject*& p_kwnames)
+    {
+        p_kwnames = NULL;
+
+        auto has_kwargs = (count > 0) && NPI::IsKeywordArguments(get(count - 1));
+        auto last       = has_kwargs ? count - 1 : count;
+
+        python_args.Reserve(python_args.Size() + last);
+        for (size_t i = 0; i < last; i++)
+        {
+            python_args.Push(NPI::ToPythonObject(get(i)));
+        }
+
+        if (has_kwargs)
+        {
+            auto n_kwargs = get(last).template As<Napi::Object>();
+
+            napi_value n_keys;
+            auto status = napi_get_all_property_names(env, n_kwargs, napi_key_own_only,
+                static_cast<napi_key_filter>(napi_key_enumerable | napi_key_skip_symbols),
+                napi_key_numbers_to_strings, &n_keys);
+            if (status != napi_ok)
+            {
+                throw Napi::Error::New(env, "Failed to enumerate the keyword arguments.");
+            }
+
+            auto n_key_list = Napi::Array(env, n_keys);
+            auto length     = n_key_list.Length();
+
+            python_args.Reserve(python_args.Size() + length + 1);
+            for (uint32_t i = 0; i < length; i++)
+            {
+                python_args.Push(NPI::ToPythonObject(n_kwargs.Get(n_key_list.Get(i))));
+            }
+
+            // Pushed after the values, which vectorcall does not read past.
+            p_kwnames = python_args.Push(NPI::InternKeyTuple(env, n_keys));
+            if (p_kwnames == NULL)
+            {
+                NPI::ThrowPythonError(env);
+            }
+        }
+
+        return last;
+    }
+}
+
+size_t NPI::ToPythonArguments(const Napi::CallbackInfo& info, size_t first, PythonReferences& python_args, PyObject*& p_kwnames)
+{
+    auto count = (info.Length() > first) ? info.Length() - first : 0;
+
+    return ConvertArguments(info.Env(), count, [&info, first](size_t i) { return info[first + i]; }, python_args, p_kwnames);
+}
+
+size_t NPI::ToPythonArguments(const Napi::Array& n_args, PythonReferences& python_args, PyObject*& p_kwnames)
+{
+    return ConvertArguments(n_args.Env(), n_args.Length(), [&n_args](size_t i) { return n_args.Get(static_cast<uint32_t>(i)); }, python_args, p_kwnames);
+}
+
+Napi::Value NPI::CallPythonMethod(const Napi::CallbackInfo& info, PyObject* p_target, size_t name_index)
+{
+    auto env = info.Env();
+
+    if (!info[name_index].IsString())
+    {
+        throw Napi::TypeError::New(env, "The name of a method must be a string.");
+    }
+
+    PythonReferences python_args;
+    python_args.Reserve(info.Length() - name_index + 2);
+
+    auto python_name = python_args.Push(InternKey(env, info[name_index]));
+    if (python_name == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    Py_INCREF(p_target);
+    python_args.Push(p_target);
+
+    PyObject* python_kwnames;
+    auto positional = ToPythonArguments(info, name_index + 1, python_args, python_kwnames);
+
+    auto python_return = PyObject_VectorcallMethod(python_name, python_args.Data() + 1, positional + 1, python_kwnames);
+    if (python_return == NULL)
+    {
+        ThrowPythonError(env);
+    }
+
+    auto node_return = ToNodeResult(env, python_return);
+    Py_DECREF(python_return);
+
+    return node_return;
+}
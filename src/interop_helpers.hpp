@@ -1,12 +1,67 @@
 #ifndef NPI_INTEROP_HELPERS_HPP
 #define NPI_INTEROP_HELPERS_HPP
 
+#include "python_helpers.hpp"
+#include "watchdog.hpp"
+
 #include <napi.h>
 #include <Python.h>
 
+#include <string>
+
 namespace NPI
 {
     void EnsurePythonInitialized(const Napi::Env& env);
+
+    /**
+     * A Python exception, detached from the interpreter so that it can cross threads.
+     */
+    struct PythonErrorInfo
+    {
+        std::string name;
+        std::string message;
+    };
+
+    /**
+     * Take the pending Python exception, clearing it. The caller must hold the GIL.
+     */
+    PythonErrorInfo FetchPythonError();
+
+    Napi::Error ToNodeError(const Napi::Env& env, const PythonErrorInfo& info);
+
+    /**
+     * Convert the pending Python exception into a `Napi::Error` and throw it. The caller must hold
+     * the GIL.
+     */
+    [[noreturn]] void ThrowPythonError(const Napi::Env& env);
+
+    /**
+     * Like `ThrowPythonError`, but a `TimeoutError` raised by the watchdog of the scope is reported
+     * as the timeout it is.
+     */
+    [[noreturn]] void ThrowPythonError(const Napi::Env& env, WatchdogScope& watch);
+
+    /**
+     * Convert the arguments of a call, from `info[first]` on, into `python_args`. A trailing object
+     * marked by `npi.kwargs` is passed as keyword arguments: its values follow the positional
+     * arguments, and its key tuple, taken from the key cache, is pushed last.
+     *
+     * @param p_kwnames Receives the key tuple, owned by `python_args`, or `NULL`.
+     * @return The number of positional arguments.
+     */
+    size_t ToPythonArguments(const Napi::CallbackInfo& info, size_t first, PythonReferences& python_args, PyObject*& p_kwnames);
+
+    /**
+     * Convert the arguments of a call from the elements of an array, see `ToPythonArguments`.
+     */
+    size_t ToPythonArguments(const Napi::Array& n_args, PythonReferences& python_args, PyObject*& p_kwnames);
+
+    /**
+     * Call a method of a Python object with `PyObject_VectorcallMethod`, without creating a bound
+     * method. The name is read from `info[name_index]` and the arguments follow it, see
+     * `ToPythonArguments`. The caller must hold the GIL.
+     */
+    Napi::Value CallPythonMethod(const Napi::CallbackInfo& info, PyObject* p_target, size_t name_index);
 }
 
 #endif
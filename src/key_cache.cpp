@@ -0,0 +1,163 @@
+#include "key_cache.hpp"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    /**
+     * Past this many keys the cache is most likely fed with data rather than keys, start over.
+     */
+    constexpr size_t KEY_CACHE_CAPACITY = 4096;
+
+    /**
+     * Keys up to this length are read without a heap allocation.
+     */
+    constexpr size_t KEY_BUFFER_SIZE = 128;
+
+    /**
+     * Past this many key lists the keyword names are most likely built from data, start over.
+     */
+    constexpr size_t KEY_TUPLE_CACHE_CAPACITY = 1024;
+
+    std::unordered_map<std::string, PyObject*> key_cache;
+
+    /**
+     * Tuples of keys by their length-prefixed concatenation.
+     */
+    std::unordered_map<std::string, PyObject*> key_tuple_cache;
+
+    void ClearKeyCache()
+    {
+        for (auto& entry : key_cache) { Py_DECREF(entry.second); }
+        key_cache.clear();
+    }
+
+    void ClearKeyTupleCache()
+    {
+        for (auto& entry : key_tuple_cache) { Py_DECREF(entry.second); }
+        key_tuple_cache.clear();
+    }
+
+    /**
+     * Append a Node string to `out` as its length followed by its UTF-8 bytes.
+     */
+    void AppendKey(napi_env env, napi_value key, std::string& out)
+    {
+        size_t length;
+        if (napi_get_value_string_utf8(env, key, NULL, 0, &length) != napi_ok)
+        {
+            throw Napi::Error::New(env, "Failed to read a property name.");
+        }
+
+        auto prefix = static_cast<uint32_t>(length);
+        out.append(reinterpret_cast<const char*>(&prefix), sizeof(prefix));
+
+        auto offset = out.size();
+        out.resize(offset + length + 1);
+        napi_get_value_string_utf8(env, key, &out[offset], length + 1, &length);
+        out.resize(offset + length);
+    }
+}
+
+PyObject* NPI::InternKey(const char* data, size_t length)
+{
+    std::string key(data, length);
+
+    auto found = key_cache.find(key);
+    if (found != key_cache.end())
+    {
+        Py_INCREF(found->second);
+        return found->second;
+    }
+
+    auto p_key = PyUnicode_DecodeUTF8(data, length, NULL);
+    if (p_key == NULL) { return NULL; }
+
+    PyUnicode_InternInPlace(&p_key);
+
+    if (key_cache.size() >= KEY_CACHE_CAPACITY) { ClearKeyCache(); }
+
+    Py_INCREF(p_key);
+    key_cache.emplace(std::move(key), p_key);
+
+    return p_key;
+}
+
+PyObject* NPI::InternKey(napi_env env, napi_value key)
+{
+    char   buffer[KEY_BUFFER_SIZE];
+    size_t length;
+
+    if (napi_get_value_string_utf8(env, key, buffer, KEY_BUFFER_SIZE, &length) != napi_ok)
+    {
+        throw Napi::Error::New(env, "Failed to read a property name.");
+    }
+
+    if (length < (KEY_BUFFER_SIZE - 1))
+    {
+        return InternKey(buffer, length);
+    }
+
+    // The key may have been truncated, read it again at its full length.
+    napi_get_value_string_utf8(env, key, NULL, 0, &length);
+
+    std::string long_key(length, '\0');
+    napi_get_value_string_utf8(env, key, &long_key[0], length + 1, &length);
+
+    return InternKey(long_key.data(), length);
+}
+
+PyObject* NPI::InternKeyTuple(napi_env env, napi_value keys)
+{
+    uint32_t count;
+    if (napi_get_array_length(env, keys, &count) != napi_ok)
+    {
+        throw Napi::Error::New(env, "Failed to read a list of property names.");
+    }
+
+    std::string joined;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        napi_value key;
+        napi_get_element(env, keys, i, &key);
+
+        AppendKey(env, key, joined);
+    }
+
+    auto found = key_tuple_cache.find(joined);
+    if (found != key_tuple_cache.end())
+    {
+        Py_INCREF(found->second);
+        return found->second;
+    }
+
+    auto p_keys = PyTuple_New(count);
+    if (p_keys == NULL) { return NULL; }
+
+    size_t offset = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t length;
+        std::memcpy(&length, joined.data() + offset, sizeof(length));
+        offset += sizeof(length);
+
+        auto p_key = InternKey(joined.data() + offset, length);
+        if (p_key == NULL)
+        {
+            Py_DECREF(p_keys);
+            return NULL;
+        }
+
+        PyTuple_SET_ITEM(p_keys, i, p_key);
+        offset += length;
+    }
+
+    if (key_tuple_cache.size() >= KEY_TUPLE_CACHE_CAPACITY) { ClearKeyTupleCache(); }
+
+    Py_INCREF(p_keys);
+    key_tuple_cache.emplace(std::move(joined), p_keys);
+
+    return p_keys;
+}
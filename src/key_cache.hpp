@@ -0,0 +1,35 @@
+#ifndef NPI_KEY_CACHE_HPP
+#define NPI_KEY_CACHE_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <cstddef>
+
+namespace NPI
+{
+    /**
+     * Get the interned Python string of a key from a small cache, so that the keys repeated across
+     * records are decoded and hashed only once. The caller must hold the GIL.
+     *
+     * @return A new reference.
+     */
+    PyObject* InternKey(const char* data, size_t length);
+
+    /**
+     * Get the interned Python string of a Node string, see `InternKey`.
+     *
+     * @return A new reference.
+     */
+    PyObject* InternKey(napi_env env, napi_value key);
+
+    /**
+     * Get the tuple of interned keys of a Node array of strings from a cache keyed by the key list,
+     * so that the keyword names of repeated calls are built only once.
+     *
+     * @return A new reference.
+     */
+    PyObject* InternKeyTuple(napi_env env, napi_value keys);
+}
+
+#endif
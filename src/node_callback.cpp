@@ -0,0 +1,288 @@
+#include "node_callback.h"
+#include "node_callback.hpp"
+#include "node_wrapper.h"
+#include "python_helpers.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    enum class CallbackKind
+    {
+        Call,
+        Release,
+    };
+
+    struct NodeCallback
+    {
+        CallbackKind kind;
+
+        /**
+         * Borrowed from the waiting thread for a call, owned for a release.
+         */
+        PyObject* callable = NULL;
+        PyObject* args     = NULL;
+        PyObject* kwargs   = NULL;
+
+        PyObject* result      = NULL;
+        PyObject* error_type  = NULL;
+        PyObject* error_value = NULL;
+        PyObject* error_trace = NULL;
+
+        /**
+         * Set when the environment went away before the call could run.
+         */
+        bool aborted = false;
+
+        bool done = false;
+
+        std::mutex mutex;
+
+        std::condition_variable finished;
+
+        NodeCallback* next = nullptr;
+    };
+
+    struct CallbackQueue
+    {
+        napi_threadsafe_function drain;
+
+        /**
+         * An intrusive stack of pending callbacks. Only the producer that finds it empty wakes the
+         * event loop, so a burst of callbacks is drained in one go.
+         */
+        std::atomic<NodeCallback*> head { nullptr };
+    };
+
+    /**
+     * The queues by environment. Posting holds the lock, so that a queue cannot be torn down under
+     * a producer.
+     */
+    std::mutex queues_mutex;
+
+    std::unordered_map<napi_env, CallbackQueue*> queues;
+
+    std::atomic<uint64_t> calls_total    { 0 };
+    std::atomic<uint64_t> releases_total { 0 };
+    std::atomic<uint64_t> batches_total  { 0 };
+
+    bool Post(napi_env env, NodeCallback* callback)
+    {
+        std::lock_guard<std::mutex> lock(queues_mutex);
+
+        auto found = queues.find(env);
+        if (found == queues.end())
+        {
+            return false;
+        }
+
+        auto queue = found->second;
+
+        callback->next = queue->head.load(std::memory_order_relaxed);
+        while (!queue->head.compare_exchange_weak(callback->next, callback, std::memory_order_release, std::memory_order_relaxed)) {}
+
+        if (callback->next == nullptr)
+        {
+            napi_call_threadsafe_function(queue->drain, nullptr, napi_tsfn_nonblocking);
+        }
+
+        return true;
+    }
+
+    /**
+     * Detach the pending callbacks, oldest first.
+     */
+    NodeCallback* TakeAll(CallbackQueue* queue)
+    {
+        auto node = queue->head.exchange(nullptr, std::memory_order_acquire);
+
+        NodeCallback* ordered = nullptr;
+        while (node != nullptr)
+        {
+            auto next  = node->next;
+            node->next = ordered;
+            ordered    = node;
+            node       = next;
+        }
+
+        return ordered;
+    }
+
+    void Finish(NodeCallback* callback)
+    {
+        // Notify under the lock, as the waiter owns the callback and returns as soon as it sees done.
+        std::lock_guard<std::mutex> lock(callback->mutex);
+        callback->done = true;
+        callback->finished.notify_one();
+    }
+
+    void OnDrain(napi_env env, napi_value, void* context, void*)
+    {
+        if (env == nullptr) { return; }
+
+        auto callback = TakeAll(static_cast<CallbackQueue*>(context));
+        if (callback == nullptr) { return; }
+
+        batches_total.fetch_add(1, std::memory_order_relaxed);
+
+        NPI::PythonEnsureGil _(NPI::GilEntry::Callback);
+
+        while (callback != nullptr)
+        {
+            auto next = callback->next;
+
+            if (callback->kind == CallbackKind::Release)
+            {
+                NPI_WrappedNodeObject_Dispose(callback->callable);
+                delete callback;
+            }
+            else
+            {
+                // On this thread, the wrapper calls the function directly. Nested bridge entries
+                // of the function re-enter the GIL held here.
+                callback->result = PyObject_Call(callback->callable, callback->args, callback->kwargs);
+                if (callback->result == NULL)
+                {
+                    PyErr_Fetch(&callback->error_type, &callback->error_value, &callback->error_trace);
+                }
+
+                Finish(callback);
+            }
+
+            callback = next;
+        }
+    }
+
+    void OnCleanup(void* data)
+    {
+        NPI::AbortNodeCallbacks(static_cast<napi_env>(data));
+    }
+}
+
+PyObject* NPI_CallNodeFromWorker(napi_env node_env, PyObject* callable, PyObject* args, PyObject* kwargs)
+{
+    NodeCallback callback;
+    callback.kind     = CallbackKind::Call;
+    callback.callable = callable;
+    callback.args     = args;
+    callback.kwargs   = kwargs;
+
+    calls_total.fetch_add(1, std::memory_order_relaxed);
+
+    bool posted;
+
+    // Released while waiting, so that the thread of the environment can run the function and any
+    // Python code it calls.
+    Py_BEGIN_ALLOW_THREADS
+    posted = Post(node_env, &callback);
+    if (posted)
+    {
+        std::unique_lock<std::mutex> lock(callback.mutex);
+        callback.finished.wait(lock, [&callback]() { return callback.done; });
+    }
+    Py_END_ALLOW_THREADS
+
+    if (!posted || callback.aborted)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "The Node environment of the function is not running.");
+        return NULL;
+    }
+
+    if (callback.result == NULL)
+    {
+        PyErr_Restore(callback.error_type, callback.error_value, callback.error_trace);
+    }
+
+    return callback.result;
+}
+
+int NPI_ReleaseNodeObjectFromWorker(napi_env node_env, PyObject* wrapper)
+{
+    auto callback      = new NodeCallback();
+    callback->kind     = CallbackKind::Release;
+    callback->callable = wrapper;
+
+    if (!Post(node_env, callback))
+    {
+        delete callback;
+        return 0;
+    }
+
+    releases_total.fetch_add(1, std::memory_order_relaxed);
+    return 1;
+}
+
+void NPI::InstallNodeCallbackQueue(const Napi::Env& env)
+{
+    auto queue = new CallbackQueue();
+
+    napi_value resource_name;
+    napi_create_string_utf8(env, "npi.callbacks", NAPI_AUTO_LENGTH, &resource_name);
+
+    auto status = napi_create_threadsafe_function(env, nullptr, nullptr, resource_name, 0, 1,
+        queue, [](napi_env, void* data, void*) { delete static_cast<CallbackQueue*>(data); },
+        queue, OnDrain, &queue->drain);
+    if (status != napi_ok)
+    {
+        delete queue;
+        throw Napi::Error::New(env, "Failed to create the callback queue of the environment.");
+    }
+
+    // A waiting thread is kept alive by the call it waits for, not by the queue.
+    napi_unref_threadsafe_function(env, queue->drain);
+
+    {
+        std::lock_guard<std::mutex> lock(queues_mutex);
+        queues[env] = queue;
+    }
+
+    napi_add_env_cleanup_hook(env, OnCleanup, static_cast<napi_env>(env));
+}
+
+void NPI::AbortNodeCallbacks(napi_env env)
+{
+    CallbackQueue* queue;
+    {
+        std::lock_guard<std::mutex> lock(queues_mutex);
+
+        auto found = queues.find(env);
+        if (found == queues.end()) { return; }
+
+        queue = found->second;
+        queues.erase(found);
+    }
+
+    auto callback = TakeAll(queue);
+    while (callback != nullptr)
+    {
+        auto next = callback->next;
+
+        if (callback->kind == CallbackKind::Release)
+        {
+            // The environment is gone along with the Node value, only the memory is left.
+            delete callback;
+        }
+        else
+        {
+            callback->aborted = true;
+            Finish(callback);
+        }
+
+        callback = next;
+    }
+
+    napi_release_threadsafe_function(queue->drain, napi_tsfn_abort);
+}
+
+NPI::NodeCallbackStats NPI::GetNodeCallbackStats()
+{
+    return NodeCallbackStats
+    {
+        calls_total.load(std::memory_order_relaxed),
+        releases_total.load(std::memory_order_relaxed),
+        batches_total.load(std::memory_order_relaxed),
+    };
+}
@@ -0,0 +1,29 @@
+#ifndef NPI_NODE_CALLBACK_H
+#define NPI_NODE_CALLBACK_H
+
+#include <node_api.h>
+#include <Python.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Call a `WrappedNodeObject` from a thread other than the one of its environment. The GIL is
+ * released while the call is posted to the event loop of the environment and run there, and taken
+ * again for the result. The caller must hold the GIL.
+ */
+PyObject* NPI_CallNodeFromWorker(napi_env node_env, PyObject* callable, PyObject* args, PyObject* kwargs);
+
+/**
+ * Hand a `WrappedNodeObject` released on another thread over to the thread of its environment,
+ * which disposes of it. Returns zero when the environment is gone.
+ */
+int NPI_ReleaseNodeObjectFromWorker(napi_env node_env, PyObject* wrapper);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef NPI_NODE_CALLBACK_HPP
+#define NPI_NODE_CALLBACK_HPP
+
+#include <napi.h>
+
+#include <cstdint>
+
+namespace NPI
+{
+    /**
+     * A snapshot of the counters of the calls into Node from other threads.
+     */
+    struct NodeCallbackStats
+    {
+        uint64_t calls;
+        uint64_t releases;
+        uint64_t batches;
+    };
+
+    /**
+     * Let the threads running Python call the Node functions of the environment, and release its
+     * wrappers, through a queue drained by its event loop. Each drain runs every pending call
+     * under a single GIL acquisition.
+     */
+    void InstallNodeCallbackQueue(const Napi::Env&);
+
+    /**
+     * Fail the pending and future calls into the environment with a `RuntimeError`. Cleanup hooks
+     * that join a thread which may be waiting on a call must run this first, since the hook of the
+     * queue itself runs after the hooks registered later.
+     */
+    void AbortNodeCallbacks(napi_env);
+
+    NodeCallbackStats GetNodeCallbackStats();
+}
+
+#endif
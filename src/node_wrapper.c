@@ -2,6 +2,7 @@
 
 #include "node_wrapper.h"
 #include "internal_helpers.h"
+#include "node_callback.h"
 #include "type_helpers.h"
 #include <structmember.h>
 
@@ -12,10 +13,20 @@ typedef struct
     napi_ref node_ref;
     napi_env node_env;
     napi_value node_bound;
+
+    // The thread of the environment, the only one that may touch the Node value.
+    unsigned long node_thread;
+
+    // Set while the reference is demoted to a weak one by a cycle probe.
+    int is_weak;
 } NPI_WrappedNodeObject;
 
 static void NPI_WrappedNodeObject_dealloc(NPI_WrappedNodeObject* self);
 
+static int NPI_WrappedNodeObject_traverse(NPI_WrappedNodeObject* self, visitproc visit, void* arg);
+
+static int NPI_WrappedNodeObject_clear(NPI_WrappedNodeObject* self);
+
 static PyObject* NPI_WrappedNodeObject_call(PyObject* self, PyObject* args, PyObject* kwargs);
 
 static int NPI_WrappedNodeObject_init(NPI_WrappedNodeObject* self, PyObject* args, PyObject* kwargs);
@@ -29,8 +40,10 @@ static PyTypeObject NPI_WrappedNodeObject_Type =
     .tp_doc       = "",
     .tp_basicsize = sizeof(NPI_WrappedNodeObject),
     .tp_itemsize  = 0,
-    .tp_flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_flags     = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
     .tp_dealloc   = NPI_WrappedNodeObject_dealloc,
+    .tp_traverse  = (traverseproc) NPI_WrappedNodeObject_traverse,
+    .tp_clear     = (inquiry) NPI_WrappedNodeObject_clear,
     .tp_call      = NPI_WrappedNodeObject_call,
     .tp_init      = NPI_WrappedNodeObject_init,
     .tp_new       = NPI_WrappedNodeObject_new,
@@ -38,32 +51,141 @@ static PyTypeObject NPI_WrappedNodeObject_Type =
 
 static void NPI_WrappedNodeObject_dealloc(NPI_WrappedNodeObject* self)
 {
+    PyObject_GC_UnTrack(self);
+
+    if ((self->node_ref != NULL) && (PyThread_get_thread_ident() != self->node_thread))
+    {
+        // Disposed of by the thread of the environment. Without an environment, the reference
+        // went away with it.
+        if (NPI_ReleaseNodeObjectFromWorker(self->node_env, (PyObject*) self))
+        {
+            return;
+        }
+
+        self->node_ref = NULL;
+    }
+
+    NPI_WrappedNodeObject_clear(self);
+
+    Py_TYPE(self)->tp_free((PyObject*) self);
+}
+
+static int NPI_WrappedNodeObject_traverse(NPI_WrappedNodeObject* Py_UNUSED(self), visitproc Py_UNUSED(visit), void* Py_UNUSED(arg))
+{
+    // The only outgoing edge is the reference into the V8 heap, which the Python collector cannot
+    // follow. Cross-heap cycles are found by the bridge cycle collector instead.
+    return 0;
+}
+
+static int NPI_WrappedNodeObject_clear(NPI_WrappedNodeObject* self)
+{
+    // Left to the deallocation, which knows how to reach the thread of the environment.
+    if (PyThread_get_thread_ident() != self->node_thread)
+    {
+        return 0;
+    }
+
     if (self->node_ref != NULL)
     {
+        napi_value node_value = NULL;
+        napi_get_reference_value(self->node_env, self->node_ref, &node_value);
+
+        if (node_value != NULL)
+        {
+            NPI_ForgetWrappedNodeObject(self->node_env, node_value, (PyObject*) self);
+        }
+
         napi_delete_reference(self->node_env, self->node_ref);
         self->node_ref = NULL;
     }
 
-    Py_TYPE(self)->tp_free((PyObject*) self);
+    self->is_weak = 0;
+
+    return 0;
+}
+
+// Raise the exception thrown by a Node function as a RuntimeError with its string form as the
+// message, and the converted exception as its `node_error` attribute.
+static void NPI_RaiseNodeError(napi_env node_env, napi_value node_error)
+{
+    napi_value node_message;
+    size_t length;
+    if ((node_error == NULL)
+        || napi_coerce_to_string(node_env, node_error, &node_message)
+        || napi_get_value_string_utf8(node_env, node_message, NULL, 0, &length))
+    {
+        // A throwing `toString` leaves an exception of its own.
+        napi_value node_ignored;
+        napi_get_and_clear_last_exception(node_env, &node_ignored);
+
+        PyErr_SetString(PyExc_RuntimeError, "The Node function threw an exception.");
+        return;
+    }
+
+    char* message = malloc(length + 1);
+    if (message == NULL)
+    {
+        PyErr_NoMemory();
+        return;
+    }
+
+    napi_get_value_string_utf8(node_env, node_message, message, length + 1, &length);
+
+    PyObject* python_error = PyObject_CallFunction(PyExc_RuntimeError, "s#", message, (Py_ssize_t) length);
+    free(message);
+
+    if (python_error == NULL)
+    {
+        return;
+    }
+
+    PyObject* python_node_error = NPI_NodeValueToPythonValue(node_env, node_error);
+    if ((python_node_error == NULL) || PyObject_SetAttrString(python_error, "node_error", python_node_error))
+    {
+        PyErr_Clear();
+    }
+
+    Py_XDECREF(python_node_error);
+
+    PyErr_SetObject(PyExc_RuntimeError, python_error);
+    Py_DECREF(python_error);
 }
 
 static PyObject* NPI_WrappedNodeObject_call(PyObject* self, PyObject* args, PyObject* kwargs)
 {
     NPI_WrappedNodeObject* casted_self = (NPI_WrappedNodeObject*) self;
-    PyObject* python_return;
+    PyObject* python_return = NULL;
+
+    napi_env node_env = casted_self->node_env;
+
+    if (PyThread_get_thread_ident() != casted_self->node_thread)
+    {
+        return NPI_CallNodeFromWorker(node_env, self, args, kwargs);
+    }
+
+    napi_value node_function = NULL;
+    if (casted_self->node_ref != NULL)
+    {
+        napi_get_reference_value(node_env, casted_self->node_ref, &node_function);
+    }
+
+    if (node_function == NULL)
+    {
+        PyErr_SetString(PyExc_ReferenceError, "The wrapped Node value was already collected.");
+        return NULL;
+    }
 
     PyObject*  sequence = PySequence_Fast(args, "");
     Py_ssize_t length   = PySequence_Size(args);
 
-    napi_value* node_args = calloc(length, sizeof(napi_value));
+    napi_value* node_args = calloc((length > 0) ? length : 1, sizeof(napi_value));
     if (node_args == NULL)
     {
+        Py_DECREF(sequence);
         PyErr_SetString(PyExc_MemoryError, "Out of memory while allocating arguments array for Node.");
         goto finally;
     }
 
-    napi_env node_env = &(casted_self->node_env);
-
     for (Py_ssize_t i = 0; i < length; i++)
     {
         PyObject*  python_arg = PySequence_Fast_GET_ITEM(sequence, i);
@@ -74,9 +196,6 @@ static PyObject* NPI_WrappedNodeObject_call(PyObject* self, PyObject* args, PyOb
 
     Py_DECREF(sequence);
 
-    napi_value node_function;
-    napi_get_reference_value(node_env, casted_self->node_ref, &node_function);
-
     napi_value node_receiver;
     if (casted_self->node_bound != NULL)
     {
@@ -94,6 +213,10 @@ static PyObject* NPI_WrappedNodeObject_call(PyObject* self, PyObject* args, PyOb
     napi_value node_return;
     if (napi_call_function(node_env, node_receiver, node_function, length, node_args, &node_return))
     {
+        napi_value node_error = NULL;
+        napi_get_and_clear_last_exception(node_env, &node_error);
+
+        NPI_RaiseNodeError(node_env, node_error);
         goto finally;
     }
 
@@ -131,6 +254,8 @@ static PyObject* NPI_WrappedNodeObject_new(PyTypeObject* type, PyObject* args, P
         self->node_ref = NULL;
         self->node_env = NULL;
         self->node_bound = NULL;
+        self->node_thread = PyThread_get_thread_ident();
+        self->is_weak = 0;
     }
 
     return (PyObject*) self;
@@ -139,6 +264,7 @@ static PyObject* NPI_WrappedNodeObject_new(PyTypeObject* type, PyObject* args, P
 static void NPI_WrappedNodeObject_AssignNodeValue(NPI_WrappedNodeObject* target, napi_env node_env, napi_value node_value)
 {
     target->node_env = node_env;
+    target->node_thread = PyThread_get_thread_ident();
 
     if (target->node_ref != NULL)
     {
@@ -147,6 +273,7 @@ static void NPI_WrappedNodeObject_AssignNodeValue(NPI_WrappedNodeObject* target,
     }
 
     napi_create_reference(node_env, node_value, 1, &(target->node_ref));
+    target->is_weak = 0;
 }
 
 static PyMemberDef NPI_WrappedNodeObject_Members[] =
@@ -180,12 +307,93 @@ static PyObject* NPI_WrappedNodeObject_getattro(PyObject* self, PyObject* attr)
     }
 }
 
+int NPI_WrappedNodeObject_Check(PyObject* target)
+{
+    return PyObject_TypeCheck(target, &NPI_WrappedNodeObject_Type);
+}
+
+PyObject* NPI_WrappedNodeObject_FromNode(napi_env node_env, napi_value node_value)
+{
+    if (PyType_Ready(&NPI_WrappedNodeObject_Type) < 0)
+    {
+        return NULL;
+    }
+
+    PyObject* target = NPI_WrappedNodeObject_new(&NPI_WrappedNodeObject_Type, NULL, NULL);
+    if (target != NULL)
+    {
+        NPI_WrappedNodeObject_AssignNodeValue((NPI_WrappedNodeObject*) target, node_env, node_value);
+    }
+
+    return target;
+}
+
 napi_value NPI_WrappedNodeObject_GetNodeValue(PyObject* target)
 {
     NPI_WrappedNodeObject* c_target = (NPI_WrappedNodeObject*) target;
 
-    napi_value value;
-    napi_get_reference_value(c_target->node_env, c_target->node_ref, &value);
+    napi_value value = NULL;
+    if (c_target->node_ref != NULL)
+    {
+        napi_get_reference_value(c_target->node_env, c_target->node_ref, &value);
+    }
 
     return value;
 }
+
+void NPI_WrappedNodeObject_Dispose(PyObject* target)
+{
+    NPI_WrappedNodeObject_clear((NPI_WrappedNodeObject*) target);
+
+    Py_TYPE(target)->tp_free(target);
+}
+
+napi_env NPI_WrappedNodeObject_GetNodeEnv(PyObject* target)
+{
+    return ((NPI_WrappedNodeObject*) target)->node_env;
+}
+
+int NPI_WrappedNodeObject_Demote(PyObject* target)
+{
+    NPI_WrappedNodeObject* c_target = (NPI_WrappedNodeObject*) target;
+
+    if ((c_target->node_ref == NULL) || c_target->is_weak)
+    {
+        return 0;
+    }
+
+    uint32_t count;
+    if (napi_reference_unref(c_target->node_env, c_target->node_ref, &count) != napi_ok)
+    {
+        return 0;
+    }
+
+    c_target->is_weak = 1;
+    return 1;
+}
+
+int NPI_WrappedNodeObject_Promote(PyObject* target)
+{
+    NPI_WrappedNodeObject* c_target = (NPI_WrappedNodeObject*) target;
+
+    if (!c_target->is_weak)
+    {
+        return (c_target->node_ref != NULL);
+    }
+
+    napi_value value = NULL;
+    napi_get_reference_value(c_target->node_env, c_target->node_ref, &value);
+
+    if (value == NULL)
+    {
+        // The target was only reachable through Python and got collected, drop the dead reference.
+        NPI_WrappedNodeObject_clear(c_target);
+        return 0;
+    }
+
+    uint32_t count;
+    napi_reference_ref(c_target->node_env, c_target->node_ref, &count);
+    c_target->is_weak = 0;
+
+    return 1;
+}
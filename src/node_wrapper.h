@@ -11,10 +11,34 @@ extern "C"
 
 PyMODINIT_FUNC PyInit_node_wrapper(void);
 
+int NPI_WrappedNodeObject_Check(PyObject*);
+
 PyObject* NPI_WrappedNodeObject_FromNode(napi_env, napi_value);
 
+/**
+ * Get the wrapped Node value, or `NULL` when it was already collected.
+ */
 napi_value NPI_WrappedNodeObject_GetNodeValue(PyObject*);
 
+napi_env NPI_WrappedNodeObject_GetNodeEnv(PyObject*);
+
+/**
+ * Finish the deallocation of a `WrappedNodeObject` released on another thread. Must be called on
+ * the thread of its environment, with the GIL held.
+ */
+void NPI_WrappedNodeObject_Dispose(PyObject*);
+
+/**
+ * Demote the reference to the Node value to a weak one. Returns non-zero when it was demoted.
+ */
+int NPI_WrappedNodeObject_Demote(PyObject*);
+
+/**
+ * Restore a demoted reference to a strong one. Returns zero when the Node value was collected in
+ * the meantime, in which case the dead reference is released.
+ */
+int NPI_WrappedNodeObject_Promote(PyObject*);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,12 +1,30 @@
 #include "npi.hpp"
 
+#include "arrow.hpp"
+#include "batch_call.hpp"
+#include "chain.hpp"
+#include "columnar.hpp"
+#include "conversion_plan.hpp"
+#include "cycle_collector.hpp"
+#include "executor.hpp"
+#include "external_memory.hpp"
+#include "gil.hpp"
+#include "instance_data.hpp"
 #include "internal_helpers.h"
 #include "interop_helpers.hpp"
+#include "node_callback.hpp"
 #include "python_helpers.hpp"
 #include "python_wrapper.hpp"
+#include "release_queue.hpp"
+#include "thread_state.hpp"
+#include "trampoline.hpp"
 #include "type_helpers.hpp"
+#include "watchdog.hpp"
 
 #include <napi.h>
+
+#include <algorithm>
+#include <cmath>
 #ifndef _WIN32
     #include <dlfcn.h>
 #endif
@@ -32,6 +50,137 @@ namespace NPI
     Napi::Value Dir(const Napi::CallbackInfo&);
 
     Napi::Value GetAttr(const Napi::CallbackInfo&);
+
+    Napi::Value Call(const Napi::CallbackInfo&);
+
+    /**
+     * Call a Python callable once per arguments of a list under a single GIL hold, capturing the
+     * error of each call in its result.
+     */
+    Napi::Value CallMany(const Napi::CallbackInfo&);
+
+    /**
+     * Run the calls of `callMany` on a worker thread and resolve to their results.
+     */
+    Napi::Value CallManyAsync(const Napi::CallbackInfo&);
+
+    /**
+     * Run a function with a timeout on the Python code it runs synchronously, which is interrupted
+     * by a `TimeoutError` past the timeout.
+     */
+    Napi::Value WithTimeout(const Napi::CallbackInfo&);
+
+    /**
+     * Call a Python callable on the executor thread and resolve to its result.
+     */
+    Napi::Value CallAsync(const Napi::CallbackInfo&);
+
+    /**
+     * Call a Python callable on the executor thread with a priority, a deadline or a tag.
+     */
+    Napi::Value Submit(const Napi::CallbackInfo&);
+
+    /**
+     * Cancel a call submitted to the executor that did not start yet.
+     */
+    Napi::Value Cancel(const Napi::CallbackInfo&);
+
+    /**
+     * Limit the number of calls of a tag queued or running on the executor at once.
+     */
+    Napi::Value SetTagLimit(const Napi::CallbackInfo&);
+
+    /**
+     * Start a lazy pipeline of operations on a Python object, run under a single GIL acquisition.
+     */
+    Napi::Value MakeChain(const Napi::CallbackInfo&);
+
+    /**
+     * Bind a Python callable into a Node function specialized for its signature.
+     */
+    Napi::Value Bind(const Napi::CallbackInfo&);
+
+    /**
+     * Call a method of a Python object in a single transition, without creating a bound method.
+     */
+    Napi::Value CallMethod(const Napi::CallbackInfo&);
+
+    /**
+     * Mark an object as the keyword arguments of a call, when passed as its last argument.
+     */
+    Napi::Value Kwargs(const Napi::CallbackInfo&);
+
+    /**
+     * Convert records, a sequence of dicts or tuples, into an object of columns.
+     */
+    Napi::Value ToColumns(const Napi::CallbackInfo&);
+
+    /**
+     * Describe an Arrow array, record batch or stream without copying its buffers.
+     */
+    Napi::Value ToArrow(const Napi::CallbackInfo&);
+
+    /**
+     * Convert a pandas DataFrame into columns that share the memory of its NumPy arrays.
+     */
+    Napi::Value FrameToColumns(const Napi::CallbackInfo&);
+
+    /**
+     * Export a described Arrow array to Python through the Arrow PyCapsule interface.
+     */
+    Napi::Value FromArrow(const Napi::CallbackInfo&);
+
+    /**
+     * Compile a declared shape into a cached conversion plan.
+     */
+    Napi::Value Schema(const Napi::CallbackInfo&);
+
+    /**
+     * Enable or disable the handle mode, in which the results of `import`, `getattr` and `call` are
+     * returned as handles instead of wrappers. Handles are accepted as targets and arguments alike,
+     * and stay valid when the mode is turned off.
+     */
+    Napi::Value SetHandleMode(const Napi::CallbackInfo&);
+
+    /**
+     * Release a handle, or an array of handles.
+     */
+    Napi::Value Release(const Napi::CallbackInfo&);
+
+    Napi::Value ReleaseAll(const Napi::CallbackInfo&);
+
+    /**
+     * Set how values are converted. Supports `dictAsMap`, one of `"never"` (the default, dicts with
+     * non-string keys stay wrapped), `"nonString"` and `"always"`, `arrow`, and `shareReadOnly` to
+     * share read-only buffers such as Arrow or copy-on-write NumPy memory instead of copying them,
+     * on the promise that they are never written to.
+     */
+    Napi::Value SetConversionOptions(const Napi::CallbackInfo&);
+
+    /**
+     * Tune the hand-off of the GIL: the switch interval of the interpreter, and the interval at
+     * which long-running bridge entries yield it.
+     */
+    Napi::Value SetGilOptions(const Napi::CallbackInfo&);
+
+    Napi::Value SetSizeHint(const Napi::CallbackInfo&);
+
+    Napi::Value SetExternalMemoryLimit(const Napi::CallbackInfo&);
+
+    /**
+     * Collect the cycles spanning the V8 and Python heaps. When Node was started with `--expose-gc`
+     * the collection happens synchronously, otherwise the probe is left to the next garbage
+     * collection before the next bridge entry.
+     */
+    Napi::Value CollectCycles(const Napi::CallbackInfo&);
+
+    Napi::Value Stats(const Napi::CallbackInfo&);
+
+    /**
+     * Clear the GIL wait and hold times reported by `stats`, e.g. before the section of interest of
+     * a benchmark.
+     */
+    Napi::Value ResetStats(const Napi::CallbackInfo&);
 }
 
 Napi::Object NPI::Init(Napi::Env env, Napi::Object exports)
@@ -45,8 +194,40 @@ Napi::Object NPI::Init(Napi::Env env, Napi::Object exports)
     exports.Set("eval", Function::New(env, Eval, STRINGIFY(Eval)));
     exports.Set("dir", Function::New(env, Dir, STRINGIFY(Dir)));
     exports.Set("getattr", Function::New(env, GetAttr, STRINGIFY(GetAttr)));
+    exports.Set("call", Function::New(env, Call, STRINGIFY(Call)));
+    exports.Set("callMany", Function::New(env, CallMany, STRINGIFY(CallMany)));
+    exports.Set("callManyAsync", Function::New(env, CallManyAsync, STRINGIFY(CallManyAsync)));
+    exports.Set("callMethod", Function::New(env, CallMethod, STRINGIFY(CallMethod)));
+    exports.Set("withTimeout", Function::New(env, WithTimeout, STRINGIFY(WithTimeout)));
+    exports.Set("callAsync", Function::New(env, CallAsync, STRINGIFY(CallAsync)));
+    exports.Set("submit", Function::New(env, Submit, STRINGIFY(Submit)));
+    exports.Set("cancel", Function::New(env, Cancel, STRINGIFY(Cancel)));
+    exports.Set("setTagLimit", Function::New(env, SetTagLimit, STRINGIFY(SetTagLimit)));
+    exports.Set("chain", Function::New(env, MakeChain, STRINGIFY(MakeChain)));
+    exports.Set("kwargs", Function::New(env, Kwargs, STRINGIFY(Kwargs)));
+    exports.Set("bind", Function::New(env, Bind, STRINGIFY(Bind)));
+    exports.Set("toColumns", Function::New(env, ToColumns, STRINGIFY(ToColumns)));
+    exports.Set("toArrow", Function::New(env, ToArrow, STRINGIFY(ToArrow)));
+    exports.Set("frameToColumns", Function::New(env, FrameToColumns, STRINGIFY(FrameToColumns)));
+    exports.Set("fromArrow", Function::New(env, FromArrow, STRINGIFY(FromArrow)));
+    exports.Set("schema", Function::New(env, Schema, STRINGIFY(Schema)));
+    exports.Set("setHandleMode", Function::New(env, SetHandleMode, STRINGIFY(SetHandleMode)));
+    exports.Set("release", Function::New(env, Release, STRINGIFY(Release)));
+    exports.Set("releaseAll", Function::New(env, ReleaseAll, STRINGIFY(ReleaseAll)));
+    exports.Set("setConversionOptions", Function::New(env, SetConversionOptions, STRINGIFY(SetConversionOptions)));
+    exports.Set("setGilOptions", Function::New(env, SetGilOptions, STRINGIFY(SetGilOptions)));
+    exports.Set("setSizeHint", Function::New(env, SetSizeHint, STRINGIFY(SetSizeHint)));
+    exports.Set("setExternalMemoryLimit", Function::New(env, SetExternalMemoryLimit, STRINGIFY(SetExternalMemoryLimit)));
+    exports.Set("collectCycles", Function::New(env, CollectCycles, STRINGIFY(CollectCycles)));
+    exports.Set("stats", Function::New(env, Stats, STRINGIFY(Stats)));
+    exports.Set("resetStats", Function::New(env, ResetStats, STRINGIFY(ResetStats)));
 
+    InitInstanceData(env);
     WrappedPythonObject::Init(env, exports);
+    ConversionPlan::Init(env, exports);
+    Chain::Init(env, exports);
+    InstallReleaseQueueHook(env);
+    InstallNodeCallbackQueue(env);
 
     return exports;
 }
@@ -100,7 +281,7 @@ Napi::Value NPI::StartInterpreter(const Napi::CallbackInfo& info)
     // See also: https://docs.python.org/3/c-api/init.html#c.PyEval_InitThreads
 #endif
 
-    PyEval_SaveThread();
+    SaveMainThreadState();
 
     return env.Undefined();
 }
@@ -133,7 +314,7 @@ Napi::Value NPI::Import(const Napi::CallbackInfo& info)
     auto name = info[0].As<Napi::String>().Utf8Value();
 
     {
-        PythonEnsureGil _;
+        PythonEnsureGil _(GilEntry::Import);
 
         auto python_name   = PyUnicode_FromString(name.c_str());
         auto python_module = PyImport_Import(python_name);
@@ -141,19 +322,13 @@ Napi::Value NPI::Import(const Napi::CallbackInfo& info)
 
         if (python_module == NULL)
         {
-            PyObject* error_type;
-            PyObject* error_value;
-            PyObject* error_trace;
-
-            PyErr_Fetch(&error_type, &error_value, &error_trace);
-
-            auto error = Napi::Error::New(env, PyUnicode_AsUTF8(PyObject_Str(error_value)));
-            error.Set("name", ((PyTypeObject*) error_type)->tp_name);
-
-            throw error;
+            ThrowPythonError(env);
         }
 
-        return ToNodeValue(env, python_module);
+        auto node_module = ToNodeResult(env, python_module);
+        Py_DECREF(python_module);
+
+        return node_module;
     }
 }
 
@@ -165,7 +340,7 @@ Napi::Value NPI::Eval(const Napi::CallbackInfo& info)
     auto program = info[0].As<Napi::String>().Utf8Value();
 
     {
-        PythonEnsureGil _;
+        PythonEnsureGil _(GilEntry::Eval);
 
         bool has_frame = (PyEval_GetFrame() != NULL);
 
@@ -177,6 +352,7 @@ Napi::Value NPI::Eval(const Napi::CallbackInfo& info)
         else
         {
             globals = has_frame ? PyEval_GetGlobals() : PyModule_GetDict(PyImport_AddModule("__main__"));
+            Py_XINCREF(globals);
         }
 
         PyObject* locals;
@@ -187,25 +363,22 @@ Napi::Value NPI::Eval(const Napi::CallbackInfo& info)
         else
         {
             locals = has_frame ? PyEval_GetLocals() : globals;
+            Py_XINCREF(locals);
         }
 
+        WatchdogScope watch(ParseTimeout(info[3]));
+
         PyObject* p_return = PyRun_String(program.c_str(), Py_eval_input, globals, locals);
+        Py_XDECREF(globals);
+        Py_XDECREF(locals);
+
         if (p_return == NULL)
         {
-            // PyErr_Print();
-
-            PyObject* error_type;
-            PyObject* error_value;
-            PyObject* error_trace;
-
-            PyErr_Fetch(&error_type, &error_value, &error_trace);
-
-            auto error = Napi::Error::New(env, PyUnicode_AsUTF8(PyObject_Str(error_value)));
-            error.Set("name", ((PyTypeObject*) error_type)->tp_name);
-
-            throw error;
+            ThrowPythonError(env, watch);
         }
 
+        watch.Disarm();
+
         auto n_return = ToNodeValue(env, p_return);
         Py_DECREF(p_return);
 
@@ -219,12 +392,21 @@ Napi::Value NPI::Dir(const Napi::CallbackInfo& info)
     EnsurePythonInitialized(env);
 
     {
-        PythonEnsureGil _;
+        PythonEnsureGil _(GilEntry::GetAttr);
 
         auto python_target = ToPythonObject(info[0]);
         auto python_keys   = PyObject_Dir(python_target);
+        Py_DECREF(python_target);
+
+        if (python_keys == NULL)
+        {
+            ThrowPythonError(env);
+        }
+
+        auto node_keys = ToNodeValue(env, python_keys);
+        Py_DECREF(python_keys);
 
-        return ToNodeValue(env, python_keys);
+        return node_keys;
     }
 }
 
@@ -234,14 +416,647 @@ Napi::Value NPI::GetAttr(const Napi::CallbackInfo& info)
     EnsurePythonInitialized(env);
 
     {
-        PythonEnsureGil _;
+        PythonEnsureGil _(GilEntry::GetAttr);
 
         auto python_target = ToPythonObject(info[0]);
         auto python_name   = ToPythonObject(info[1]);
         auto python_value  = PyObject_GetAttr(python_target, python_name);
+        Py_DECREF(python_target);
+        Py_DECREF(python_name);
+
+        if (python_value == NULL)
+        {
+            ThrowPythonError(env);
+        }
+
+        auto node_value = ToNodeResult(env, python_value);
+        Py_DECREF(python_value);
+
+        return node_value;
+    }
+}
+
+Napi::Value NPI::Call(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+        PythonReferences python_args;
+
+        auto python_target = python_args.Push(ToPythonObject(info[0]));
+
+        PyObject* python_kwnames;
+        auto positional = ToPythonArguments(info, 1, python_args, python_kwnames);
+
+        auto python_return = PyObject_Vectorcall(python_target, python_args.Data() + 1, positional, python_kwnames);
+        if (python_return == NULL)
+        {
+            ThrowPythonError(env);
+        }
 
-        return ToNodeValue(env, python_value);
+        auto node_return = ToNodeResult(env, python_return);
+        Py_DECREF(python_return);
+
+        return node_return;
+    }
+}
+
+Napi::Value NPI::CallMany(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+        PythonReferences python_args;
+
+        auto python_function = python_args.Push(ToPythonObject(info[0]));
+
+        return NPI::CallPythonBatch(env, python_function, info[1], ParseBatchOptions(info[2]));
+    }
+}
+
+Napi::Value NPI::CallManyAsync(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Async);
+        PythonReferences python_args;
+
+        auto python_function = python_args.Push(ToPythonObject(info[0]));
+
+        return NPI::CallPythonBatchAsync(env, python_function, info[1], ParseBatchOptions(info[2]));
+    }
+}
+
+Napi::Value NPI::CallMethod(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+        PythonReferences python_args;
+
+        auto python_target = python_args.Push(ToPythonObject(info[0]));
+
+        return CallPythonMethod(info, python_target, 1);
+    }
+}
+
+Napi::Value NPI::WithTimeout(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    if (!info[0].IsNumber() || !info[1].IsFunction())
+    {
+        throw Napi::TypeError::New(env, "withTimeout() takes a timeout in milliseconds and a function.");
+    }
+
+    auto timeout_ms = std::max(0.0, info[0].As<Napi::Number>().DoubleValue());
+    auto token      = ArmWatchdog(DeadlineAfter(timeout_ms));
+
+    Napi::Value n_result;
+    try
+    {
+        n_result = info[1].As<Napi::Function>().Call({});
+    }
+    catch (Napi::Error& error)
+    {
+        bool fired;
+        {
+            PythonEnsureGil _;
+            fired = DisarmWatchdog(token);
+        }
+
+        // The watchdog raises the bare class, so the entry point that surfaced it left no message.
+        auto n_value = error.Value();
+        auto n_error = n_value.IsObject() ? n_value.As<Napi::Object>() : Napi::Object();
+        if (fired && !n_error.IsEmpty() && n_error.Get("name").StrictEquals(Napi::String::New(env, "TimeoutError")))
+        {
+            n_error.Set("message", DescribeTimeout(timeout_ms));
+        }
+
+        throw;
+    }
+    catch (...)
+    {
+        PythonEnsureGil _;
+        DisarmWatchdog(token);
+
+        throw;
     }
+
+    {
+        PythonEnsureGil _;
+        DisarmWatchdog(token);
+    }
+
+    return n_result;
+}
+
+Napi::Value NPI::CallAsync(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Async);
+        PythonReferences python_args;
+
+        python_args.Push(ToPythonObject(info[0]));
+
+        PyObject* python_kwnames;
+        auto positional = ToPythonArguments(info, 1, python_args, python_kwnames);
+
+        return GetExecutor(env).Submit(env, python_args, positional, python_kwnames, ExecutorOptions());
+    }
+}
+
+Napi::Value NPI::Submit(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    if (!info[1].IsArray() && !info[1].IsUndefined())
+    {
+        throw Napi::TypeError::New(env, "The arguments of a call must be an array.");
+    }
+
+    auto options = ParseExecutorOptions(info[2]);
+
+    {
+        PythonEnsureGil _(GilEntry::Async);
+        PythonReferences python_args;
+
+        python_args.Push(ToPythonObject(info[0]));
+
+        PyObject* python_kwnames = NULL;
+        size_t positional        = 0;
+        if (info[1].IsArray())
+        {
+            positional = ToPythonArguments(info[1].As<Napi::Array>(), python_args, python_kwnames);
+        }
+
+        return GetExecutor(env).Submit(env, python_args, positional, python_kwnames, options);
+    }
+}
+
+Napi::Value NPI::Cancel(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    auto executor = GetInstanceData(env).executor;
+    if ((executor == nullptr) || !info[0].IsNumber())
+    {
+        return Napi::Boolean::New(env, false);
+    }
+
+    {
+        PythonEnsureGil _(GilEntry::Async);
+
+        auto id = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+
+        return Napi::Boolean::New(env, executor->Cancel(env, id));
+    }
+}
+
+Napi::Value NPI::SetTagLimit(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    if (!info[0].IsString() || !info[1].IsNumber())
+    {
+        throw Napi::TypeError::New(env, "setTagLimit() takes a tag and a limit.");
+    }
+
+    auto tag   = info[0].As<Napi::String>().Utf8Value();
+    auto limit = std::max<int64_t>(0, info[1].As<Napi::Number>().Int64Value());
+
+    {
+        PythonEnsureGil _(GilEntry::Async);
+
+        GetExecutor(env).SetTagLimit(env, tag, static_cast<size_t>(limit));
+    }
+
+    return env.Undefined();
+}
+
+Napi::Value NPI::MakeChain(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+        PythonReferences python_args;
+
+        auto python_root = python_args.Push(ToPythonObject(info[0]));
+
+        return Chain::New(env, python_root);
+    }
+}
+
+Napi::Value NPI::Kwargs(const Napi::CallbackInfo& info)
+{
+    return MarkKeywordArguments(info[0]);
+}
+
+Napi::Value NPI::Bind(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+        PythonReferences python_args;
+
+        auto python_function = python_args.Push(ToPythonObject(info[0]));
+
+        return BindFunction(env, python_function, info[1]);
+    }
+}
+
+Napi::Value NPI::ToColumns(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Convert);
+        PythonReferences python_args;
+
+        auto python_records = python_args.Push(ToPythonObject(info[0]));
+
+        return ToNodeColumns(env, python_records, info[1]);
+    }
+}
+
+Napi::Value NPI::ToArrow(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Convert);
+        PythonReferences python_args;
+
+        auto python_object = python_args.Push(ToPythonObject(info[0]));
+
+        return ToNodeArrow(env, python_object);
+    }
+}
+
+Napi::Value NPI::FrameToColumns(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Convert);
+        PythonReferences python_args;
+
+        auto python_frame = python_args.Push(ToPythonObject(info[0]));
+
+        return ToNodeDataFrame(env, python_frame);
+    }
+}
+
+Napi::Value NPI::FromArrow(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Convert);
+        PythonReferences python_args;
+
+        auto python_array = python_args.Push(ToPythonArrow(info[0]));
+
+        return ToNodeResult(env, python_array);
+    }
+}
+
+Napi::Value NPI::Schema(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    auto strict = info[1].IsObject() && info[1].As<Napi::Object>().Get("strict").ToBoolean();
+
+    {
+        PythonEnsureGil _(GilEntry::Convert);
+
+        return ConversionPlan::Compile(env, info[0], strict);
+    }
+}
+
+Napi::Value NPI::SetHandleMode(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+
+    GetInstanceData(env).handle_mode = info[0].ToBoolean().Value();
+
+    return env.Undefined();
+}
+
+Napi::Value NPI::Release(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    auto& handles = GetInstanceData(env).handles;
+
+    {
+        PythonEnsureGil _(GilEntry::Release);
+
+        if (info[0].IsArray())
+        {
+            auto node_handles = info[0].As<Napi::Array>();
+            auto length       = node_handles.Length();
+
+            size_t count = 0;
+            for (uint32_t i = 0; i < length; i++)
+            {
+                auto node_handle = node_handles.Get(i);
+                count += IsHandle(node_handle) && handles.Release(GetHandleId(node_handle));
+            }
+
+            return Napi::Number::New(env, count);
+        }
+
+        return Napi::Boolean::New(env, IsHandle(info[0]) && handles.Release(GetHandleId(info[0])));
+    }
+}
+
+Napi::Value NPI::ReleaseAll(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Release);
+
+        return Napi::Number::New(env, GetInstanceData(env).handles.ReleaseAll());
+    }
+}
+
+Napi::Value NPI::SetConversionOptions(const Napi::CallbackInfo& info)
+{
+    auto env     = info.Env();
+    auto options = info[0].ToObject();
+    auto& data   = GetInstanceData(env);
+
+    if (options.Has("dictAsMap"))
+    {
+        auto dict_as_map = options.Get("dictAsMap").ToString().Utf8Value();
+
+        if (dict_as_map == "never")
+        {
+            data.map_output = MapOutput::Never;
+        }
+        else if (dict_as_map == "nonString")
+        {
+            data.map_output = MapOutput::NonStringKeys;
+        }
+        else if (dict_as_map == "always")
+        {
+            data.map_output = MapOutput::Always;
+        }
+        else
+        {
+            throw Napi::RangeError::New(env, "The dictAsMap option must be one of never, nonString or always.");
+        }
+    }
+
+    if (options.Has("arrow"))
+    {
+        data.arrow_output = options.Get("arrow").ToBoolean();
+    }
+
+    if (options.Has("shareReadOnly"))
+    {
+        data.share_readonly = options.Get("shareReadOnly").ToBoolean();
+    }
+
+    return env.Undefined();
+}
+
+Napi::Value NPI::SetGilOptions(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    auto options = info[0].IsObject() ? info[0].As<Napi::Object>() : Napi::Object::New(env);
+
+    if (options.Has("yieldIntervalMs"))
+    {
+        SetGilYieldInterval(options.Get("yieldIntervalMs").ToNumber().DoubleValue());
+    }
+
+    double switch_interval;
+    {
+        PythonEnsureGil _;
+        PythonReferences python_values;
+
+        auto python_sys = python_values.Push(PyImport_ImportModule("sys"));
+        if (python_sys == NULL)
+        {
+            ThrowPythonError(env);
+        }
+
+        if (options.Has("switchIntervalMs"))
+        {
+            auto seconds = options.Get("switchIntervalMs").ToNumber().DoubleValue() / 1000;
+            if (python_values.Push(PyObject_CallMethod(python_sys, "setswitchinterval", "d", seconds)) == NULL)
+            {
+                ThrowPythonError(env);
+            }
+        }
+
+        auto python_interval = python_values.Push(PyObject_CallMethod(python_sys, "getswitchinterval", NULL));
+        if (python_interval == NULL)
+        {
+            ThrowPythonError(env);
+        }
+
+        switch_interval = PyFloat_AsDouble(python_interval) * 1000;
+    }
+
+    auto current = Napi::Object::New(env);
+    current.Set("switchIntervalMs", Napi::Number::New(env, switch_interval));
+    current.Set("yieldIntervalMs", Napi::Number::New(env, GetGilYieldInterval()));
+
+    return current;
+}
+
+Napi::Value NPI::SetSizeHint(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+
+    if (!info[0].IsObject() || !IsWrappedPythonObject(info[0].ToObject()))
+    {
+        throw Napi::TypeError::New(env, "The target must be a wrapped Python object.");
+    }
+
+    auto size = info[1].IsNumber() ? info[1].As<Napi::Number>().DoubleValue() : -1;
+    if (!(size >= 0) || !std::isfinite(size))
+    {
+        throw Napi::RangeError::New(env, "The size hint must be a finite number of bytes, at least 0.");
+    }
+
+    WrappedPythonObject::Unwrap(info[0].ToObject())->SetExternalSize(env, static_cast<int64_t>(size));
+
+    return env.Undefined();
+}
+
+Napi::Value NPI::SetExternalMemoryLimit(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+
+    SetExternalMemoryThreshold(IsNullLike(info[0]) ? 0 : info[0].As<Napi::Number>().Int64Value());
+
+    return env.Undefined();
+}
+
+Napi::Value NPI::CollectCycles(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    auto result = Napi::Object::New(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Release);
+
+        auto demoted = BeginCycleProbe(env);
+        result.Set("demoted", Napi::Number::New(env, demoted));
+
+        auto gc = env.Global().Get("gc");
+        if ((demoted > 0) && gc.IsFunction())
+        {
+            gc.As<Napi::Function>().Call({});
+            result.Set("collected", Napi::Number::New(env, EndCycleProbe()));
+        }
+    }
+
+    return result;
+}
+
+Napi::Value NPI::Stats(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+
+    auto release_stats = GetReleaseQueueStats();
+    auto release_queue = Napi::Object::New(env);
+    release_queue.Set("pending", Napi::Number::New(env, release_stats.pending));
+    release_queue.Set("highWater", Napi::Number::New(env, release_stats.high_water));
+    release_queue.Set("scheduled", Napi::Number::New(env, release_stats.scheduled));
+    release_queue.Set("released", Napi::Number::New(env, release_stats.released));
+    release_queue.Set("batches", Napi::Number::New(env, release_stats.batches));
+
+    auto memory_stats    = GetExternalMemoryStats();
+    auto external_memory = Napi::Object::New(env);
+    external_memory.Set("tracked", Napi::Number::New(env, memory_stats.tracked));
+    external_memory.Set("limit", Napi::Number::New(env, memory_stats.limit));
+    external_memory.Set("gcHints", Napi::Number::New(env, memory_stats.gc_hints));
+
+    auto cycle_stats = GetCycleCollectorStats();
+    auto cycles      = Napi::Object::New(env);
+    cycles.Set("probes", Napi::Number::New(env, cycle_stats.probes));
+    cycles.Set("demoted", Napi::Number::New(env, cycle_stats.demoted));
+    cycles.Set("restored", Napi::Number::New(env, cycle_stats.restored));
+    cycles.Set("collected", Napi::Number::New(env, cycle_stats.collected));
+    cycles.Set("probing", Napi::Boolean::New(env, cycle_stats.probing));
+
+    auto handles = Napi::Object::New(env);
+    handles.Set("live", Napi::Number::New(env, GetInstanceData(env).handles.Size()));
+
+    auto executor_stats = GetExecutorStats(env);
+    auto executor       = Napi::Object::New(env);
+    executor.Set("running", Napi::Boolean::New(env, executor_stats.running));
+    executor.Set("outstanding", Napi::Number::New(env, executor_stats.outstanding));
+    executor.Set("submitted", Napi::Number::New(env, executor_stats.submitted));
+    executor.Set("completed", Napi::Number::New(env, executor_stats.completed));
+    executor.Set("rejected", Napi::Number::New(env, executor_stats.rejected));
+    executor.Set("cancelled", Napi::Number::New(env, executor_stats.cancelled));
+    executor.Set("expired", Napi::Number::New(env, executor_stats.expired));
+    executor.Set("interrupted", Napi::Number::New(env, executor_stats.interrupted));
+    executor.Set("batches", Napi::Number::New(env, executor_stats.batches));
+
+    auto watchdog_stats = GetWatchdogStats();
+    auto watchdog       = Napi::Object::New(env);
+    watchdog.Set("active", Napi::Number::New(env, watchdog_stats.active));
+    watchdog.Set("armed", Napi::Number::New(env, watchdog_stats.armed));
+    watchdog.Set("fired", Napi::Number::New(env, watchdog_stats.fired));
+
+    auto thread_state_stats = GetThreadStateStats();
+    auto thread_states      = Napi::Object::New(env);
+    thread_states.Set("created", Napi::Number::New(env, thread_state_stats.created));
+    thread_states.Set("acquired", Napi::Number::New(env, thread_state_stats.acquired));
+    thread_states.Set("mainEntries", Napi::Number::New(env, thread_state_stats.main_entries));
+    thread_states.Set("nestedEntries", Napi::Number::New(env, thread_state_stats.nested_entries));
+
+    auto callback_stats = GetNodeCallbackStats();
+    auto node_callbacks = Napi::Object::New(env);
+    node_callbacks.Set("calls", Napi::Number::New(env, callback_stats.calls));
+    node_callbacks.Set("releases", Napi::Number::New(env, callback_stats.releases));
+    node_callbacks.Set("batches", Napi::Number::New(env, callback_stats.batches));
+
+    auto summarize = [env](const HistogramSummary& summary)
+    {
+        auto times = Napi::Object::New(env);
+        times.Set("count", Napi::Number::New(env, summary.count));
+        times.Set("meanMs", Napi::Number::New(env, (summary.count > 0) ? summary.total / 1e6 / summary.count : 0));
+        times.Set("p50Ms", Napi::Number::New(env, summary.p50 / 1e6));
+        times.Set("p90Ms", Napi::Number::New(env, summary.p90 / 1e6));
+        times.Set("p99Ms", Napi::Number::New(env, summary.p99 / 1e6));
+        times.Set("p999Ms", Napi::Number::New(env, summary.p999 / 1e6));
+        times.Set("maxMs", Napi::Number::New(env, summary.max / 1e6));
+
+        return times;
+    };
+
+    auto gil = Napi::Object::New(env);
+    for (size_t i = 0; i < GIL_ENTRY_COUNT; i++)
+    {
+        auto entry      = static_cast<GilEntry>(i);
+        auto hold_stats = GetGilHoldStats(entry);
+
+        auto timings = Napi::Object::New(env);
+        timings.Set("wait", summarize(hold_stats.wait));
+        timings.Set("hold", summarize(hold_stats.hold));
+        timings.Set("yields", Napi::Number::New(env, hold_stats.yields));
+
+        gil.Set(GetGilEntryName(entry), timings);
+    }
+
+    auto stats = Napi::Object::New(env);
+    stats.Set("releaseQueue", release_queue);
+    stats.Set("externalMemory", external_memory);
+    stats.Set("cycles", cycles);
+    stats.Set("handles", handles);
+    stats.Set("executor", executor);
+    stats.Set("watchdog", watchdog);
+    stats.Set("threadStates", thread_states);
+    stats.Set("nodeCallbacks", node_callbacks);
+    stats.Set("gil", gil);
+
+    return stats;
+}
+
+Napi::Value NPI::ResetStats(const Napi::CallbackInfo& info)
+{
+    ResetGilStats();
+
+    return info.Env().Undefined();
 }
 
 Napi::Value NPI::Symbols::Repr(Napi::Env env)
@@ -1,57 +1,162 @@
 #ifndef NPI_PYTHON_HELPERS_HPP
 #define NPI_PYTHON_HELPERS_HPP
 
+#include "cycle_collector.hpp"
+#include "gil.hpp"
+#include "release_queue.hpp"
+
 #include <Python.h>
 
+#include <chrono>
+#include <vector>
+
+#if PY_VERSION_HEX < 0x03080000
+    #error "Python 3.8 or later is required, for the vectorcall protocol."
+#endif
+
+#if PY_VERSION_HEX < 0x03090000
+    #define PyObject_Vectorcall _PyObject_Vectorcall
+
+    inline PyObject* PyObject_VectorcallMethod(PyObject* name, PyObject* const* args, size_t nargsf, PyObject* kwnames)
+    {
+        auto method = PyObject_GetAttr(args[0], name);
+        if (method == NULL) { return NULL; }
+
+        auto result = _PyObject_Vectorcall(method, args + 1, PyVectorcall_NARGS(nargsf) - 1, kwnames);
+        Py_DECREF(method);
+
+        return result;
+    }
+#endif
+
 namespace NPI
 {
-    class PythonEnsureGil
+    /**
+     * Acquire the GIL for the current scope. On the thread that started the interpreter, its saved
+     * thread state is restored with `PyEval_RestoreThread` and saved again on exit, and nested
+     * scopes only count their depth. Other threads go through `PyGILState_Ensure`.
+     */
+    class PythonThreadContext
     {
         public:
-            PythonEnsureGil();
+            PythonThreadContext();
 
-            ~PythonEnsureGil();
+            ~PythonThreadContext();
+
+            PythonThreadContext(const PythonThreadContext&) = delete;
+
+            PythonThreadContext& operator=(const PythonThreadContext&) = delete;
+
+            /**
+             * Whether the GIL was actually taken by this scope, rather than already held.
+             */
+            bool IsOutermost() const
+            {
+                return (m_mode == Mode::Restored) || ((m_mode == Mode::GilState) && (m_state == PyGILState_UNLOCKED));
+            }
 
         private:
+            enum class Mode
+            {
+                Restored,
+                Nested,
+                GilState,
+            };
+
+            Mode m_mode;
+
             PyGILState_STATE m_state;
     };
 
-    class PythonThreadContext
+    /**
+     * Acquire the GIL for the current scope. Entering the bridge also drains the deferred release
+     * queue, so references dropped by finalizers are released in one batch, and ends any running
+     * cycle probe before Python code gets a chance to run.
+     */
+    class PythonEnsureGil
     {
         public:
-            PythonThreadContext();
+            /**
+             * @param entry The kind of entry that the hold of the GIL is timed as.
+             */
+            explicit PythonEnsureGil(GilEntry entry = GilEntry::Other);
 
-            ~PythonThreadContext();
+            ~PythonEnsureGil();
 
         private:
-            PyGILState_STATE m_state;
+            /**
+             * Taken before the GIL is, so that the wait for it can be timed.
+             */
+            std::chrono::steady_clock::time_point m_requested;
 
-            PyThreadState* m_thread_state;
+            PythonThreadContext m_context;
     };
-}
 
-NPI::PythonEnsureGil::PythonEnsureGil()
-{
-    m_state = PyGILState_Ensure();
-}
+    /**
+     * A list of owned Python references, released when going out of scope. Must be declared after
+     * the PythonEnsureGil of the scope, so that it is destroyed while the GIL is still held.
+     */
+    class PythonReferences
+    {
+        public:
+            PythonReferences() = default;
 
-NPI::PythonEnsureGil::~PythonEnsureGil()
-{
-    PyGILState_Release(m_state);
+            PythonReferences(const PythonReferences&) = delete;
+
+            PythonReferences& operator=(const PythonReferences&) = delete;
+
+            ~PythonReferences()
+            {
+                for (auto object : m_objects) { Py_XDECREF(object); }
+            }
+
+            void Reserve(size_t capacity) { m_objects.reserve(capacity); }
+
+            /**
+             * Take ownership of a new reference.
+             */
+            PyObject* Push(PyObject* object)
+            {
+                m_objects.push_back(object);
+                return object;
+            }
+
+            /**
+             * Give up the ownership of the references, e.g. to hand them over to another thread.
+             */
+            std::vector<PyObject*> Detach()
+            {
+                auto objects = std::move(m_objects);
+                m_objects.clear();
+
+                return objects;
+            }
+
+            PyObject* const* Data() const { return m_objects.data(); }
+
+            size_t Size() const { return m_objects.size(); }
+
+        private:
+            std::vector<PyObject*> m_objects;
+    };
 }
 
-NPI::PythonThreadContext::PythonThreadContext()
+inline NPI::PythonEnsureGil::PythonEnsureGil(GilEntry entry) : m_requested(std::chrono::steady_clock::now())
 {
-    m_state = PyGILState_Ensure();
+    if (m_context.IsOutermost())
+    {
+        BeginGilHold(entry, m_requested);
+    }
+
+    DrainReleaseQueue();
+    EndCycleProbe();
 }
 
-NPI::PythonThreadContext::~PythonThreadContext()
+inline NPI::PythonEnsureGil::~PythonEnsureGil()
 {
-    PyGILState_Release(m_state);
-
-    if (PyGILState_Check() == 1)
+    if (m_context.IsOutermost())
     {
-        m_thread_state = PyEval_SaveThread();
+        EndGilHold();
     }
 }
 
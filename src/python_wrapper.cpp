@@ -1,19 +1,53 @@
 #include "python_wrapper.hpp"
+#include "external_memory.hpp"
+#include "instance_data.hpp"
+#include "interop_helpers.hpp"
 #include "internal_helpers.h"
+#include "python_helpers.hpp"
+#include "release_queue.hpp"
 
 Napi::FunctionReference NPI::WrappedPythonObject::m_constructor;
 
+namespace
+{
+    const napi_type_tag wrapper_type_tag = { 0x4e50495772617070ULL, 0x8d3c5a1e67b2f904ULL };
+
+    /**
+     * The object to wrap by the constructor call of WrappedPythonObject::New, handed over natively
+     * instead of through an external argument.
+     */
+    thread_local PyObject* pending_python_value = nullptr;
+}
+
 Napi::Object NPI::WrappedPythonObject::New(Napi::Env env, PyObject* python_value)
 {
-    auto python_value_ref = Napi::External<PyObject>::New(env, python_value);
-    return Constructor().New({ python_value_ref });
+    auto& wrappers = GetInstanceData(env).python_wrappers;
+
+    auto found = wrappers.find(python_value);
+    if (found != wrappers.end())
+    {
+        // The wrapper may have been collected while its finalizer has not run yet.
+        auto wrapper = found->second->NodeValue();
+        if (!wrapper.IsEmpty()) { return wrapper; }
+    }
+
+    pending_python_value = python_value;
+    return Constructor().New({});
+}
+
+bool NPI::WrappedPythonObject::IsInstance(const Napi::Object& object)
+{
+    bool result = false;
+    napi_check_object_type_tag(object.Env(), object, &wrapper_type_tag, &result);
+
+    return result;
 }
 
 Napi::Object NPI::WrappedPythonObject::Init(Napi::Env env, Napi::Object exports)
 {
     auto function = DefineClass(env, STRINGIFY(WrappedPythonObject),
         {
-
+            InstanceMethod("callMethod", &WrappedPythonObject::CallMethod),
         });
 
     m_constructor = Napi::Persistent(function);
@@ -26,11 +60,58 @@ Napi::Object NPI::WrappedPythonObject::Init(Napi::Env env, Napi::Object exports)
 NPI::WrappedPythonObject::WrappedPythonObject(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<WrappedPythonObject>(info)
 {
-    m_python_value = info[0].As<Napi::External<PyObject>>().Data();
+    if (pending_python_value != nullptr)
+    {
+        m_python_value       = pending_python_value;
+        pending_python_value = nullptr;
+    }
+    else if (info[0].IsExternal())
+    {
+        m_python_value = info[0].As<Napi::External<PyObject>>().Data();
+    }
+    else
+    {
+        throw Napi::TypeError::New(info.Env(), STRINGIFY(WrappedPythonObject) " cannot be constructed from JavaScript.");
+    }
+
     Py_INCREF(m_python_value);
+    napi_type_tag_object(info.Env(), info.This(), &wrapper_type_tag);
+
+    m_external_size = EstimateExternalSize(m_python_value);
+    AdjustExternalMemory(info.Env(), m_external_size);
+
+    GetInstanceData(info.Env()).python_wrappers[m_python_value] = this;
 }
 
 NPI::WrappedPythonObject::~WrappedPythonObject()
 {
-    Py_DECREF(m_python_value);
+    auto& wrappers = GetInstanceData(Env()).python_wrappers;
+
+    auto found = wrappers.find(m_python_value);
+    if ((found != wrappers.end()) && (found->second == this))
+    {
+        wrappers.erase(found);
+    }
+
+    // Finalizers run without the GIL, so the reference is released at the next bridge entry instead.
+    ScheduleDecref(m_python_value);
+    AdjustExternalMemory(Env(), -m_external_size);
+}
+
+void NPI::WrappedPythonObject::SetExternalSize(const Napi::Env& env, int64_t size)
+{
+    AdjustExternalMemory(env, size - m_external_size);
+    m_external_size = size;
+}
+
+Napi::Value NPI::WrappedPythonObject::CallMethod(const Napi::CallbackInfo& info)
+{
+    auto env = info.Env();
+    EnsurePythonInitialized(env);
+
+    {
+        PythonEnsureGil _(GilEntry::Call);
+
+        return CallPythonMethod(info, m_python_value, 0);
+    }
 }
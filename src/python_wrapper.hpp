@@ -15,14 +15,39 @@ namespace NPI
 
             static Napi::Object Init(Napi::Env env, Napi::Object exports);
 
+            /**
+             * Wrap a Python object, reusing the live wrapper of the object when there is one.
+             */
             static Napi::Object New(Napi::Env env, PyObject* python_value);
 
+            /**
+             * Check whether an object is a wrapper by its type tag, without walking the prototype chain.
+             */
+            static bool IsInstance(const Napi::Object& object);
+
             const PyObject* python_value() const { return m_python_value; }
 
             PyObject* python_value() { return m_python_value; }
 
             PyObject* Value() { return m_python_value; }
 
+            /**
+             * The JavaScript object of this wrapper, or an empty object when it was already collected.
+             */
+            Napi::Object NodeValue() { return ObjectWrap::Value(); }
+
+            /**
+             * Replace the estimated size of the wrapped object reported to V8, e.g. with a size hint
+             * supplied by the user.
+             */
+            void SetExternalSize(const Napi::Env& env, int64_t size);
+
+            /**
+             * `wrapper.callMethod(name, ...args)`, calls a method of the wrapped object without
+             * creating a bound method.
+             */
+            Napi::Value CallMethod(const Napi::CallbackInfo& info);
+
             WrappedPythonObject(const Napi::CallbackInfo& info);
 
             ~WrappedPythonObject();
@@ -30,6 +55,8 @@ namespace NPI
             static Napi::FunctionReference m_constructor;
 
             PyObject* m_python_value;
+
+            int64_t m_external_size;
     };
 };
 
@@ -0,0 +1,212 @@
+#include "release_queue.hpp"
+#include "cycle_collector.hpp"
+#include "external_memory.hpp"
+#include "python_helpers.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <uv.h>
+
+namespace
+{
+    struct PendingDecref
+    {
+        PyObject*      object;
+        PendingDecref* next;
+    };
+
+    /**
+     * Head of an intrusive Treiber stack. Producers push with a CAS, the consumer detaches the whole
+     * list with a single exchange, so any number of threads may schedule while one drains.
+     */
+    std::atomic<PendingDecref*> pending_head { nullptr };
+
+    struct PendingUnref
+    {
+        napi_env      env;
+        napi_ref      reference;
+        PendingUnref* next;
+    };
+
+    /**
+     * Node references released off the JS thread, e.g. by the consumer of an exported Arrow array.
+     */
+    std::atomic<PendingUnref*> unref_head { nullptr };
+
+    /**
+     * The environments with an installed hook. References of any other environment went away with
+     * it, so only their node is left to free.
+     */
+    std::mutex live_envs_mutex;
+
+    std::unordered_set<napi_env> live_envs;
+
+    void PushUnref(PendingUnref* node)
+    {
+        node->next = unref_head.load(std::memory_order_relaxed);
+        while (!unref_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    bool IsLive(napi_env env)
+    {
+        std::lock_guard<std::mutex> lock(live_envs_mutex);
+        return live_envs.count(env) != 0;
+    }
+
+    /**
+     * Delete the pending references of the environment. References of other live environments are
+     * pushed back for their own hook, those of closed environments are dropped.
+     */
+    void DrainUnrefs(napi_env env)
+    {
+        if (unref_head.load(std::memory_order_relaxed) == nullptr) { return; }
+
+        auto node = unref_head.exchange(nullptr, std::memory_order_acquire);
+        while (node != nullptr)
+        {
+            auto next = node->next;
+
+            if (node->env == env)
+            {
+                napi_delete_reference(env, node->reference);
+                delete node;
+            }
+            else if (IsLive(node->env))
+            {
+                PushUnref(node);
+            }
+            else
+            {
+                delete node;
+            }
+
+            node = next;
+        }
+    }
+
+    std::atomic<size_t>   pending_count    { 0 };
+    std::atomic<size_t>   pending_high     { 0 };
+    std::atomic<uint64_t> scheduled_total  { 0 };
+    std::atomic<uint64_t> released_total   { 0 };
+    std::atomic<uint64_t> batches_total    { 0 };
+
+    void OnCheck(uv_check_t* handle)
+    {
+        DrainUnrefs(static_cast<napi_env>(handle->data));
+        NPI::RunPendingGarbageCollection(Napi::Env(static_cast<napi_env>(handle->data)));
+
+        if (((pending_head.load(std::memory_order_relaxed) == nullptr) && !NPI::IsCycleProbeActive()) || !Py_IsInitialized())
+        {
+            return;
+        }
+
+        // Releasing objects may touch Node values, which needs a handle scope outside of a callback.
+        Napi::HandleScope scope(static_cast<napi_env>(handle->data));
+
+        // Acquiring the GIL drains the queue and ends the cycle probe.
+        NPI::PythonEnsureGil _(NPI::GilEntry::Release);
+    }
+
+    void OnCleanup(void* data)
+    {
+        auto handle = static_cast<uv_check_t*>(data);
+        auto env    = static_cast<napi_env>(handle->data);
+
+        // Unrefs scheduled from now on find the environment closed.
+        {
+            std::lock_guard<std::mutex> lock(live_envs_mutex);
+            live_envs.erase(env);
+        }
+
+        DrainUnrefs(env);
+
+        uv_check_stop(handle);
+        uv_close(reinterpret_cast<uv_handle_t*>(handle), [](uv_handle_t* handle)
+        {
+            delete reinterpret_cast<uv_check_t*>(handle);
+        });
+    }
+}
+
+void NPI::ScheduleDecref(PyObject* p_object)
+{
+    if (p_object == NULL) { return; }
+
+    auto node = new PendingDecref { p_object, pending_head.load(std::memory_order_relaxed) };
+    while (!pending_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+
+    auto depth = pending_count.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto high  = pending_high.load(std::memory_order_relaxed);
+    while ((depth > high) && !pending_high.compare_exchange_weak(high, depth, std::memory_order_relaxed)) {}
+
+    scheduled_total.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NPI::ScheduleUnref(napi_env env, napi_ref reference)
+{
+    if (reference == nullptr) { return; }
+
+    PushUnref(new PendingUnref { env, reference, nullptr });
+}
+
+size_t NPI::DrainReleaseQueue()
+{
+    if (pending_head.load(std::memory_order_relaxed) == nullptr) { return 0; }
+
+    auto node = pending_head.exchange(nullptr, std::memory_order_acquire);
+
+    size_t count = 0;
+    while (node != nullptr)
+    {
+        auto next = node->next;
+
+        Py_DECREF(node->object);
+        delete node;
+
+        node = next;
+        count++;
+    }
+
+    pending_count.fetch_sub(count, std::memory_order_relaxed);
+    released_total.fetch_add(count, std::memory_order_relaxed);
+    batches_total.fetch_add(1, std::memory_order_relaxed);
+
+    return count;
+}
+
+void NPI::InstallReleaseQueueHook(const Napi::Env& env)
+{
+    uv_loop_t* loop;
+    if (napi_get_uv_event_loop(env, &loop) != napi_ok)
+    {
+        throw Napi::Error::New(env, "Failed to retrieve the event loop of Node.");
+    }
+
+    auto handle = new uv_check_t;
+    uv_check_init(loop, handle);
+    handle->data = static_cast<napi_env>(env);
+    uv_check_start(handle, OnCheck);
+
+    {
+        std::lock_guard<std::mutex> lock(live_envs_mutex);
+        live_envs.insert(env);
+    }
+
+    // The hook must not keep the process alive by itself.
+    uv_unref(reinterpret_cast<uv_handle_t*>(handle));
+
+    napi_add_env_cleanup_hook(env, OnCleanup, handle);
+}
+
+NPI::ReleaseQueueStats NPI::GetReleaseQueueStats()
+{
+    return ReleaseQueueStats
+    {
+        pending_count.load(std::memory_order_relaxed),
+        pending_high.load(std::memory_order_relaxed),
+        scheduled_total.load(std::memory_order_relaxed),
+        released_total.load(std::memory_order_relaxed),
+        batches_total.load(std::memory_order_relaxed),
+    };
+}
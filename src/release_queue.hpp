@@ -0,0 +1,52 @@
+#ifndef NPI_RELEASE_QUEUE_HPP
+#define NPI_RELEASE_QUEUE_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace NPI
+{
+    /**
+     * A snapshot of the deferred release queue counters.
+     */
+    struct ReleaseQueueStats
+    {
+        size_t   pending;
+        size_t   high_water;
+        uint64_t scheduled;
+        uint64_t released;
+        uint64_t batches;
+    };
+
+    /**
+     * Schedule a `Py_DECREF` to be performed the next time the queue is drained. Lock-free, and safe
+     * to call from any thread without holding the GIL (e.g. from a V8 finalizer).
+     */
+    void ScheduleDecref(PyObject*);
+
+    /**
+     * Schedule the deletion of a Node reference on the thread of its environment, the next time its
+     * event loop runs the check phase. Lock-free, and safe to call from any thread.
+     */
+    void ScheduleUnref(napi_env, napi_ref);
+
+    /**
+     * Release every pending reference in one batch. The caller must hold the GIL.
+     *
+     * @return The number of references released.
+     */
+    size_t DrainReleaseQueue();
+
+    /**
+     * Install a `uv_check` hook on the event loop of the environment, so that pending references are
+     * released even when no bridge entry happens for a while.
+     */
+    void InstallReleaseQueueHook(const Napi::Env&);
+
+    ReleaseQueueStats GetReleaseQueueStats();
+}
+
+#endif
@@ -0,0 +1,163 @@
+#include "thread_state.hpp"
+#include "gil.hpp"
+#include "python_helpers.hpp"
+#include "release_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+namespace
+{
+    /**
+     * The thread state of the current worker thread, created on first use. It stays registered
+     * with the GIL state API, so that callees using `PyGILState_Ensure` find it instead of
+     * creating one of their own.
+     */
+    thread_local PyThreadState* worker_state = nullptr;
+
+    thread_local size_t worker_depth = 0;
+
+    std::atomic<uint64_t> created_total  { 0 };
+    std::atomic<uint64_t> acquired_total { 0 };
+
+    /**
+     * Whether the thread state of the thread that started the interpreter was saved, by any
+     * thread.
+     */
+    std::atomic<bool> main_saved { false };
+
+    /**
+     * Set on the thread that started the interpreter only, so that other threads never read its
+     * state below.
+     */
+    thread_local bool is_main_thread = false;
+
+    /**
+     * The thread state of the main thread while it is outside of the bridge, and its active bridge
+     * entries. Only touched by the main thread.
+     */
+    PyThreadState* main_state = nullptr;
+
+    size_t main_depth = 0;
+
+    std::atomic<uint64_t> main_entries   { 0 };
+    std::atomic<uint64_t> nested_entries { 0 };
+}
+
+void NPI::SaveMainThreadState()
+{
+    // Only once, by the thread that holds the GIL since initializing the interpreter.
+    if ((PyGILState_Check() == 0) || main_saved.exchange(true))
+    {
+        return;
+    }
+
+    is_main_thread = true;
+    main_state     = PyEval_SaveThread();
+}
+
+NPI::PythonThreadContext::PythonThreadContext()
+{
+    if (!is_main_thread)
+    {
+        m_mode  = Mode::GilState;
+        m_state = PyGILState_Ensure();
+
+        return;
+    }
+
+    if (main_depth == 0)
+    {
+        m_mode = Mode::Restored;
+        main_depth++;
+        main_entries.fetch_add(1, std::memory_order_relaxed);
+
+        PyEval_RestoreThread(main_state);
+
+        return;
+    }
+
+    // Re-entered from a callback while the outer entry holds the GIL. Should the outer entry have
+    // let go of the GIL meanwhile, the generic path takes it again.
+    if (PyGILState_Check() == 1)
+    {
+        m_mode = Mode::Nested;
+        main_depth++;
+        nested_entries.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_mode  = Mode::GilState;
+        m_state = PyGILState_Ensure();
+    }
+}
+
+NPI::PythonThreadContext::~PythonThreadContext()
+{
+    switch (m_mode)
+    {
+        case Mode::Restored:
+            main_depth--;
+            main_state = PyEval_SaveThread();
+            break;
+
+        case Mode::Nested:
+            main_depth--;
+            break;
+
+        case Mode::GilState:
+            PyGILState_Release(m_state);
+            break;
+    }
+}
+
+NPI::PythonWorkerGil::PythonWorkerGil()
+{
+    if (worker_depth++ > 0)
+    {
+        return;
+    }
+
+    acquired_total.fetch_add(1, std::memory_order_relaxed);
+
+    auto requested = std::chrono::steady_clock::now();
+    if (worker_state == nullptr)
+    {
+        // Created on the thread itself, so that it carries the id of the thread that runs it. The
+        // GIL state is never released, which keeps the thread state alive.
+        PyGILState_Ensure();
+        worker_state = PyThreadState_Get();
+
+        created_total.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        PyEval_RestoreThread(worker_state);
+    }
+
+    BeginGilHold(GilEntry::Async, requested);
+    DrainReleaseQueue();
+}
+
+NPI::PythonWorkerGil::~PythonWorkerGil()
+{
+    if (--worker_depth > 0)
+    {
+        return;
+    }
+
+    EndGilHold();
+    PyEval_SaveThread();
+}
+
+NPI::ThreadStateStats NPI::GetThreadStateStats()
+{
+    return ThreadStateStats
+    {
+        created_total.load(std::memory_order_relaxed),
+        acquired_total.load(std::memory_order_relaxed),
+        main_entries.load(std::memory_order_relaxed),
+        nested_entries.load(std::memory_order_relaxed),
+    };
+}
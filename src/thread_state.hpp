@@ -0,0 +1,51 @@
+#ifndef NPI_THREAD_STATE_HPP
+#define NPI_THREAD_STATE_HPP
+
+#include <Python.h>
+
+#include <cstdint>
+
+namespace NPI
+{
+    /**
+     * A snapshot of the worker thread state counters.
+     */
+    struct ThreadStateStats
+    {
+        uint64_t created;
+        uint64_t acquired;
+        uint64_t main_entries;
+        uint64_t nested_entries;
+    };
+
+    /**
+     * Release the GIL after starting the interpreter, keeping the thread state of the thread for
+     * the bridge entries that follow, see `PythonThreadContext`. Does nothing when the GIL is not
+     * held, e.g. when the interpreter was already started.
+     */
+    void SaveMainThreadState();
+
+    /**
+     * Acquire the GIL for the current scope on a worker thread, such as a thread of the libuv pool.
+     *
+     * `PyGILState_Ensure` creates and destroys a thread state every time on a thread without one.
+     * Instead, every worker thread gets a thread state of its own on first use, kept for the life
+     * of the thread, and the GIL is then taken with `PyEval_RestoreThread` and handed back with
+     * `PyEval_SaveThread`. Nested scopes on the same thread only count their depth.
+     */
+    class PythonWorkerGil
+    {
+        public:
+            PythonWorkerGil();
+
+            ~PythonWorkerGil();
+
+            PythonWorkerGil(const PythonWorkerGil&) = delete;
+
+            PythonWorkerGil& operator=(const PythonWorkerGil&) = delete;
+    };
+
+    ThreadStateStats GetThreadStateStats();
+}
+
+#endif
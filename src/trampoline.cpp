@@ -0,0 +1,597 @@
+#include "trampoline.hpp"
+#include "interop_helpers.hpp"
+#include "python_helpers.hpp"
+#include "release_queue.hpp"
+#include "type_helpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+ * The largest arity with a trampoline of its own, larger arities share a dynamic one.
+ */
+#define MAX_TRAMPOLINE_ARITY 8
+
+namespace
+{
+    enum class SignatureType
+    {
+        Any,
+        Bool,
+        Float64,
+        Int32,
+        Int64,
+        String,
+        Void,
+    };
+
+    using ArgumentConverter = PyObject* (*)(const Napi::Env&, const Napi::Value&);
+
+    using ResultConverter = Napi::Value (*)(const Napi::Env&, PyObject*);
+
+    /**
+     * Convert an argument. The napi accessors behind the `As` casts throw when the value has
+     * another type, so that no type is checked beforehand.
+     *
+     * @return A new reference.
+     */
+    template <SignatureType T>
+    PyObject* ToPythonArgument(const Napi::Env& env, const Napi::Value& n_value);
+
+    template <>
+    PyObject* ToPythonArgument<SignatureType::Any>(const Napi::Env&, const Napi::Value& n_value)
+    {
+        return NPI::ToPythonObject(n_value);
+    }
+
+    template <>
+    PyObject* ToPythonArgument<SignatureType::Bool>(const Napi::Env&, const Napi::Value& n_value)
+    {
+        return PyBool_FromLong(n_value.As<Napi::Boolean>().Value());
+    }
+
+    template <>
+    PyObject* ToPythonArgument<SignatureType::Float64>(const Napi::Env& env, const Napi::Value& n_value)
+    {
+        auto p_value = PyFloat_FromDouble(n_value.As<Napi::Number>().DoubleValue());
+        if (p_value == NULL) { NPI::ThrowPythonError(env); }
+
+        return p_value;
+    }
+
+    /**
+     * Read a Number that must be an integer within a range. The napi integer casts wrap and
+     * truncate silently, so the double is checked first.
+     */
+    double ToIntegral(const Napi::Env& env, const Napi::Value& n_value, double min, double max, const char* type)
+    {
+        auto value = n_value.As<Napi::Number>().DoubleValue();
+        if (std::trunc(value) != value)
+        {
+            throw Napi::TypeError::New(env, std::string("The argument is not an integer, as an ") + type + " must be.");
+        }
+
+        if ((value < min) || (value > max))
+        {
+            throw Napi::RangeError::New(env, std::string("The argument does not fit in an ") + type + ".");
+        }
+
+        return value;
+    }
+
+    template <>
+    PyObject* ToPythonArgument<SignatureType::Int32>(const Napi::Env& env, const Napi::Value& n_value)
+    {
+        auto value   = ToIntegral(env, n_value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(), "i32");
+        auto p_value = PyLong_FromLong(static_cast<long>(value));
+        if (p_value == NULL) { NPI::ThrowPythonError(env); }
+
+        return p_value;
+    }
+
+    template <>
+    PyObject* ToPythonArgument<SignatureType::Int64>(const Napi::Env& env, const Napi::Value& n_value)
+    {
+        int64_t value;
+        if (n_value.IsBigInt())
+        {
+            bool lossless;
+            value = n_value.As<Napi::BigInt>().Int64Value(&lossless);
+            if (!lossless)
+            {
+                throw Napi::RangeError::New(env, "The argument does not fit in an i64.");
+            }
+        }
+        else
+        {
+            // 2^63 is the first double past the range, as INT64_MAX rounds up to it.
+            value = static_cast<int64_t>(ToIntegral(env, n_value, -9223372036854775808.0, std::nextafter(9223372036854775808.0, 0.0), "i64"));
+        }
+
+        auto p_value = PyLong_FromLongLong(value);
+        if (p_value == NULL) { NPI::ThrowPythonError(env); }
+
+        return p_value;
+    }
+
+    template <>
+    PyObject* ToPythonArgument<SignatureType::String>(const Napi::Env& env, const Napi::Value& n_value)
+    {
+        auto value   = n_value.As<Napi::String>().Utf8Value();
+        auto p_value = PyUnicode_FromStringAndSize(value.data(), value.size());
+        if (p_value == NULL) { NPI::ThrowPythonError(env); }
+
+        return p_value;
+    }
+
+    /**
+     * Convert a result, raising a TypeError from Python when it has another type.
+     */
+    template <SignatureType T>
+    Napi::Value ToNodeResult(const Napi::Env& env, PyObject* p_value);
+
+    template <>
+    Napi::Value ToNodeResult<SignatureType::Any>(const Napi::Env& env, PyObject* p_value)
+    {
+        return NPI::ToNodeResult(env, p_value);
+    }
+
+    template <>
+    Napi::Value ToNodeResult<SignatureType::Void>(const Napi::Env& env, PyObject*)
+    {
+        return env.Undefined();
+    }
+
+    template <>
+    Napi::Value ToNodeResult<SignatureType::Bool>(const Napi::Env& env, PyObject* p_value)
+    {
+        auto value = PyObject_IsTrue(p_value);
+        if (value < 0) { NPI::ThrowPythonError(env); }
+
+        return Napi::Boolean::New(env, value != 0);
+    }
+
+    template <>
+    Napi::Value ToNodeResult<SignatureType::Float64>(const Napi::Env& env, PyObject* p_value)
+    {
+        auto value = PyFloat_CheckExact(p_value) ? PyFloat_AS_DOUBLE(p_value) : PyFloat_AsDouble(p_value);
+        if ((value == -1.0) && PyErr_Occurred()) { NPI::ThrowPythonError(env); }
+
+        return Napi::Number::New(env, value);
+    }
+
+    template <>
+    Napi::Value ToNodeResult<SignatureType::Int32>(const Napi::Env& env, PyObject* p_value)
+    {
+        auto value = PyLong_AsLong(p_value);
+        if ((value == -1) && PyErr_Occurred()) { NPI::ThrowPythonError(env); }
+
+        if ((value < INT32_MIN) || (value > INT32_MAX))
+        {
+            throw Napi::RangeError::New(env, "The result does not fit in an i32.");
+        }
+
+        return Napi::Number::New(env, static_cast<double>(value));
+    }
+
+    template <>
+    Napi::Value ToNodeResult<SignatureType::Int64>(const Napi::Env& env, PyObject* p_value)
+    {
+        auto value = PyLong_AsLongLong(p_value);
+        if ((value == -1) && PyErr_Occurred()) { NPI::ThrowPythonError(env); }
+
+        return Napi::BigInt::New(env, static_cast<int64_t>(value));
+    }
+
+    template <>
+    Napi::Value ToNodeResult<SignatureType::String>(const Napi::Env& env, PyObject* p_value)
+    {
+        Py_ssize_t length;
+        auto data = PyUnicode_AsUTF8AndSize(p_value, &length);
+        if (data == NULL) { NPI::ThrowPythonError(env); }
+
+        return Napi::String::New(env, data, length);
+    }
+
+    ArgumentConverter GetArgumentConverter(SignatureType type)
+    {
+        switch (type)
+        {
+            case SignatureType::Bool:    return ToPythonArgument<SignatureType::Bool>;
+            case SignatureType::Float64: return ToPythonArgument<SignatureType::Float64>;
+            case SignatureType::Int32:   return ToPythonArgument<SignatureType::Int32>;
+            case SignatureType::Int64:   return ToPythonArgument<SignatureType::Int64>;
+            case SignatureType::String:  return ToPythonArgument<SignatureType::String>;
+            default:                     return ToPythonArgument<SignatureType::Any>;
+        }
+    }
+
+    ResultConverter GetResultConverter(SignatureType type)
+    {
+        switch (type)
+        {
+            case SignatureType::Bool:    return ToNodeResult<SignatureType::Bool>;
+            case SignatureType::Float64: return ToNodeResult<SignatureType::Float64>;
+            case SignatureType::Int32:   return ToNodeResult<SignatureType::Int32>;
+            case SignatureType::Int64:   return ToNodeResult<SignatureType::Int64>;
+            case SignatureType::String:  return ToNodeResult<SignatureType::String>;
+            case SignatureType::Void:    return ToNodeResult<SignatureType::Void>;
+            default:                     return ToNodeResult<SignatureType::Any>;
+        }
+    }
+
+    const char* TypeName(SignatureType type)
+    {
+        switch (type)
+        {
+            case SignatureType::Any:     return "any";
+            case SignatureType::Bool:    return "bool";
+            case SignatureType::Float64: return "f64";
+            case SignatureType::Int32:   return "i32";
+            case SignatureType::Int64:   return "i64";
+            case SignatureType::String:  return "str";
+            case SignatureType::Void:    return "void";
+        }
+
+        return "any";
+    }
+
+    /**
+     * Parse a type of a signature string, or of a Python annotation given by its name.
+     *
+     * @return Whether the name is known.
+     */
+    bool ParseType(std::string name, SignatureType& type)
+    {
+        auto begin = name.find_first_not_of(" \t");
+        auto end   = name.find_last_not_of(" \t");
+        name = (begin == std::string::npos) ? std::string() : name.substr(begin, end - begin + 1);
+
+        if ((name == "any") || name.empty())               { type = SignatureType::Any;     return true; }
+        if (name == "bool")                                { type = SignatureType::Bool;    return true; }
+        if ((name == "f64") || (name == "float"))          { type = SignatureType::Float64; return true; }
+        if (name == "i32")                                 { type = SignatureType::Int32;   return true; }
+        if ((name == "i64") || (name == "int"))            { type = SignatureType::Int64;   return true; }
+        if ((name == "str") || (name == "string"))         { type = SignatureType::String;  return true; }
+        if ((name == "void") || (name == "None"))          { type = SignatureType::Void;    return true; }
+
+        return false;
+    }
+
+    struct Signature
+    {
+        std::vector<SignatureType> arguments;
+
+        /**
+         * The number of leading arguments without a default. The others are only passed when
+         * given, so that their defaults apply.
+         */
+        size_t required = 0;
+
+        /**
+         * Whether every given argument is passed as `any`, for callables whose signature cannot be
+         * inspected.
+         */
+        bool variadic = false;
+
+        SignatureType result = SignatureType::Any;
+    };
+
+    Signature ParseSignature(const Napi::Env& env, const std::string& text)
+    {
+        auto arrow = text.find("->");
+        if (arrow == std::string::npos)
+        {
+            throw Napi::TypeError::New(env, "A signature must have the form \"a, b -> result\".");
+        }
+
+        Signature signature;
+
+        auto arguments = text.substr(0, arrow);
+        if (arguments.find_first_not_of(" \t") != std::string::npos)
+        {
+            size_t start = 0;
+            while (true)
+            {
+                auto comma = arguments.find(',', start);
+                auto name  = arguments.substr(start, (comma == std::string::npos) ? std::string::npos : comma - start);
+
+                SignatureType type;
+                if (!ParseType(name, type) || (type == SignatureType::Void))
+                {
+                    throw Napi::TypeError::New(env, "Unknown argument type in signature: " + name);
+                }
+
+                signature.arguments.push_back(type);
+
+                if (comma == std::string::npos) { break; }
+                start = comma + 1;
+            }
+        }
+
+        auto result = text.substr(arrow + 2);
+        if (!ParseType(result, signature.result))
+        {
+            throw Napi::TypeError::New(env, "Unknown result type in signature: " + result);
+        }
+
+        signature.required = signature.arguments.size();
+
+        return signature;
+    }
+
+    /**
+     * Map an annotation to a type, `any` when it has no specialized converter. An `int` result
+     * stays `any`, so that it converts like the result of `call` does.
+     */
+    SignatureType FromAnnotation(PyObject* p_annotation, PyObject* p_empty, bool is_result)
+    {
+        if (p_annotation == p_empty)                                          { return SignatureType::Any; }
+        if (is_result && ((p_annotation == Py_None) || (p_annotation == reinterpret_cast<PyObject*>(Py_TYPE(Py_None))))) { return SignatureType::Void; }
+        if (p_annotation == reinterpret_cast<PyObject*>(&PyFloat_Type))       { return SignatureType::Float64; }
+        if (p_annotation == reinterpret_cast<PyObject*>(&PyBool_Type))        { return SignatureType::Bool; }
+        if (p_annotation == reinterpret_cast<PyObject*>(&PyLong_Type))        { return is_result ? SignatureType::Any : SignatureType::Int64; }
+        if (p_annotation == reinterpret_cast<PyObject*>(&PyUnicode_Type))     { return SignatureType::String; }
+
+        // Postponed annotations are strings.
+        if (PyUnicode_Check(p_annotation))
+        {
+            auto name = std::string(PyUnicode_AsUTF8(p_annotation));
+
+            if (name == "float")                 { return SignatureType::Float64; }
+            if (name == "bool")                  { return SignatureType::Bool; }
+            if (name == "int")                   { return is_result ? SignatureType::Any : SignatureType::Int64; }
+            if (name == "str")                   { return SignatureType::String; }
+            if (is_result && (name == "None"))   { return SignatureType::Void; }
+        }
+
+        return SignatureType::Any;
+    }
+
+    /**
+     * Infer the signature of a callable from `inspect.signature`. Only the positional parameters
+     * are bound. Builtins without a text signature get a variadic binding.
+     */
+    Signature InferSignature(const Napi::Env& env, PyObject* p_function)
+    {
+        NPI::PythonReferences python_refs;
+
+        auto p_inspect   = python_refs.Push(PyImport_ImportModule("inspect"));
+        auto p_signature = (p_inspect != NULL) ? python_refs.Push(PyObject_CallMethod(p_inspect, "signature", "O", p_function)) : NULL;
+        if ((p_signature == NULL) && PyErr_ExceptionMatches(PyExc_ValueError))
+        {
+            PyErr_Clear();
+
+            Signature signature;
+            signature.variadic = true;
+
+            return signature;
+        }
+
+        auto p_empty     = (p_signature != NULL) ? python_refs.Push(PyObject_GetAttrString(p_signature, "empty")) : NULL;
+        auto p_params    = (p_empty != NULL) ? python_refs.Push(PyObject_GetAttrString(p_signature, "parameters")) : NULL;
+        auto p_values    = (p_params != NULL) ? python_refs.Push(PyObject_CallMethod(p_params, "values", NULL)) : NULL;
+        auto p_list      = (p_values != NULL) ? python_refs.Push(PySequence_List(p_values)) : NULL;
+        auto p_result    = (p_list != NULL) ? python_refs.Push(PyObject_GetAttrString(p_signature, "return_annotation")) : NULL;
+        if (p_result == NULL)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        Signature signature;
+
+        for (Py_ssize_t i = 0; i < PyList_GET_SIZE(p_list); i++)
+        {
+            auto p_param = PyList_GET_ITEM(p_list, i);
+
+            auto p_kind       = python_refs.Push(PyObject_GetAttrString(p_param, "kind"));
+            auto p_kind_name  = (p_kind != NULL) ? python_refs.Push(PyObject_GetAttrString(p_kind, "name")) : NULL;
+            auto p_annotation = (p_kind_name != NULL) ? python_refs.Push(PyObject_GetAttrString(p_param, "annotation")) : NULL;
+            auto p_default    = (p_annotation != NULL) ? python_refs.Push(PyObject_GetAttrString(p_param, "default")) : NULL;
+            if (p_default == NULL)
+            {
+                NPI::ThrowPythonError(env);
+            }
+
+            auto kind = std::string(PyUnicode_AsUTF8(p_kind_name));
+            if ((kind != "POSITIONAL_ONLY") && (kind != "POSITIONAL_OR_KEYWORD"))
+            {
+                break;
+            }
+
+            signature.arguments.push_back(FromAnnotation(p_annotation, p_empty, false));
+
+            // Parameters after one with a default have a default too.
+            if ((p_default == p_empty) && (signature.required == signature.arguments.size() - 1))
+            {
+                signature.required++;
+            }
+        }
+
+        signature.result = FromAnnotation(p_result, p_empty, true);
+
+        return signature;
+    }
+
+    /**
+     * The state of a bound function, freed with the Node function.
+     */
+    struct BoundFunction
+    {
+        PyObject* p_function;
+
+        std::vector<ArgumentConverter> arguments;
+
+        size_t required;
+
+        bool variadic;
+
+        ResultConverter result;
+
+        /**
+         * The number of arguments to pass for a call with `given` arguments. Missing arguments
+         * without a default are passed as `None`.
+         */
+        size_t Arity(size_t given) const
+        {
+            return variadic ? given : std::min(arguments.size(), std::max(required, given));
+        }
+
+        ~BoundFunction()
+        {
+            NPI::ScheduleDecref(p_function);
+        }
+    };
+
+    Napi::Value Finish(const Napi::Env& env, const BoundFunction* bound, PyObject* p_result)
+    {
+        if (p_result == NULL)
+        {
+            NPI::ThrowPythonError(env);
+        }
+
+        try
+        {
+            auto n_result = bound->result(env, p_result);
+            Py_DECREF(p_result);
+
+            return n_result;
+        }
+        catch (...)
+        {
+            Py_DECREF(p_result);
+            throw;
+        }
+    }
+
+    /**
+     * The trampoline of a fixed arity, with the arguments on the stack.
+     */
+    template <size_t N>
+    Napi::Value Trampoline(const Napi::CallbackInfo& info)
+    {
+        auto env   = info.Env();
+        auto bound = static_cast<const BoundFunction*>(info.Data());
+
+        NPI::PythonEnsureGil _(NPI::GilEntry::Call);
+
+        PyObject* p_args[N + 1];
+
+        auto arity = bound->Arity(info.Length());
+
+        size_t converted = 0;
+        try
+        {
+            for (; converted < arity; converted++)
+            {
+                p_args[converted] = bound->arguments[converted](env, info[converted]);
+            }
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < converted; i++) { Py_DECREF(p_args[i]); }
+            throw;
+        }
+
+        auto p_result = PyObject_Vectorcall(bound->p_function, p_args, arity, NULL);
+
+        for (size_t i = 0; i < arity; i++) { Py_DECREF(p_args[i]); }
+
+        return Finish(env, bound, p_result);
+    }
+
+    Napi::Value DynamicTrampoline(const Napi::CallbackInfo& info)
+    {
+        auto env   = info.Env();
+        auto bound = static_cast<const BoundFunction*>(info.Data());
+
+        NPI::PythonEnsureGil _(NPI::GilEntry::Call);
+        NPI::PythonReferences python_args;
+
+        auto arity = bound->Arity(info.Length());
+
+        python_args.Reserve(arity);
+        for (size_t i = 0; i < arity; i++)
+        {
+            python_args.Push(bound->variadic ? NPI::ToPythonObject(info[i]) : bound->arguments[i](env, info[i]));
+        }
+
+        return Finish(env, bound, PyObject_Vectorcall(bound->p_function, python_args.Data(), python_args.Size(), NULL));
+    }
+
+    Napi::Function::Callback GetTrampoline(size_t arity)
+    {
+        static const Napi::Function::Callback trampolines[MAX_TRAMPOLINE_ARITY + 1] =
+        {
+            Trampoline<0>, Trampoline<1>, Trampoline<2>, Trampoline<3>, Trampoline<4>,
+            Trampoline<5>, Trampoline<6>, Trampoline<7>, Trampoline<8>,
+        };
+
+        return (arity <= MAX_TRAMPOLINE_ARITY) ? trampolines[arity] : DynamicTrampoline;
+    }
+}
+
+Napi::Value NPI::BindFunction(const Napi::Env& env, PyObject* p_function, const Napi::Value& n_signature)
+{
+    if (!PyCallable_Check(p_function))
+    {
+        throw Napi::TypeError::New(env, "Only callables can be bound.");
+    }
+
+    auto signature = n_signature.IsString()
+        ? ParseSignature(env, n_signature.As<Napi::String>().Utf8Value())
+        : InferSignature(env, p_function);
+
+    auto bound = new BoundFunction { p_function, {}, signature.required, signature.variadic, GetResultConverter(signature.result) };
+    Py_INCREF(p_function);
+
+    std::string text = signature.variadic ? "...any" : "";
+    for (size_t i = 0; i < signature.arguments.size(); i++)
+    {
+        auto type = signature.arguments[i];
+        bound->arguments.push_back(GetArgumentConverter(type));
+
+        if (!text.empty()) { text += ", "; }
+        text += TypeName(type);
+        if (i >= signature.required) { text += '?'; }
+    }
+    text += std::string(text.empty() ? "-> " : " -> ") + TypeName(signature.result);
+
+    std::string name = "bound";
+    if (auto p_name = PyObject_GetAttrString(p_function, "__name__"))
+    {
+        if (PyUnicode_Check(p_name)) { name = PyUnicode_AsUTF8(p_name); }
+        Py_DECREF(p_name);
+    }
+    PyErr_Clear();
+
+    Napi::Function n_function;
+    try
+    {
+        auto trampoline = bound->variadic ? DynamicTrampoline : GetTrampoline(bound->arguments.size());
+        n_function = Napi::Function::New(env, trampoline, name, bound);
+    }
+    catch (...)
+    {
+        delete bound;
+        throw;
+    }
+
+    auto status = napi_add_finalizer(env, n_function, bound, [](napi_env, void* data, void*)
+    {
+        delete static_cast<BoundFunction*>(data);
+    }, nullptr, nullptr);
+
+    if (status != napi_ok)
+    {
+        delete bound;
+        throw Napi::Error::New(env);
+    }
+
+    n_function.Set("signature", Napi::String::New(env, text));
+
+    return n_function;
+}
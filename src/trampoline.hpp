@@ -0,0 +1,25 @@
+#ifndef NPI_TRAMPOLINE_HPP
+#define NPI_TRAMPOLINE_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+namespace NPI
+{
+    /**
+     * Bind a Python callable into a Node function specialized for its signature.
+     *
+     * The signature is either a string such as `"f64, f64 -> f64"`, with the types `f64`, `i32`,
+     * `i64`, `bool`, `str` and `any` (and `void` for the result), or nothing to infer it from the
+     * annotations of the callable. The converters of every argument and of the result are chosen
+     * once, and the call goes through a trampoline instantiated for the arity. Inferred parameters
+     * with a default are only passed when given, and callables without an inspectable signature
+     * take any arguments. An inferred `int` result converts as `any`, like the result of `call`,
+     * and integer arguments must be Numbers that fit the type exactly, or BigInts for `i64`.
+     *
+     * @param p_function The callable to bind. The caller must hold the GIL.
+     */
+    Napi::Value BindFunction(const Napi::Env& env, PyObject* p_function, const Napi::Value& n_signature);
+}
+
+#endif
@@ -1,9 +1,28 @@
 #include "type_helpers.h"
 #include "type_helpers.hpp"
+#include "arrow.hpp"
+#include "instance_data.hpp"
+#include "interop_helpers.hpp"
+#include "key_cache.hpp"
+#include "node_wrapper.h"
 #include "python_wrapper.hpp"
+#include "release_queue.hpp"
+
+#include <cstring>
+#include <vector>
 
 #define UINT64_SIZE sizeof(uint64_t)
 
+/**
+ * The maximum nesting of containers converted in either direction, which also stops cyclic
+ * objects.
+ */
+#define MAX_CONTAINER_DEPTH 1024
+
+static const napi_type_tag keyword_arguments_type_tag = { 0x4e50494b77617267ULL, 0x3b9e0c71d25a4f86ULL };
+
+static const napi_type_tag handle_type_tag = { 0x4e504948616e646cULL, 0x8f2d6a41c7e3b509ULL };
+
 #if LONG_WIDTH == INT64_WIDTH
     #define PyLong_AsInt64(object) PyLong_AsLong(object);
 #elif LLONG_WIDTH == INT64_WIDTH
@@ -20,7 +39,48 @@ namespace NPI
 {
     bool IsSafeInteger(const Napi::Env& env, const Napi::Value& payload);
 
-    bool IsWrappedPythonObject(const Napi::Object& payload);
+    /**
+     * Wrap a Node value into a WrappedNodeObject, reusing the live wrapper of the value when there
+     * is one.
+     *
+     * @param n_env   The current Node environment.
+     * @param n_value The Node value to wrap.
+     */
+    PyObject* ToWrappedNodeObject(const Napi::Env &n_env, const Napi::Value &n_value);
+
+    /**
+     * Check whether a Node value is an object created by a literal or `Object.create(null)`.
+     */
+    bool IsPlainObject(const Napi::Env &n_env, const Napi::Value &n_value);
+
+    /**
+     * Convert a plain object into a dict. Nested plain objects and arrays are converted iteratively
+     * with an explicit stack, so the depth of a payload is not limited by the native stack.
+     *
+     * @param n_env   The current Node environment.
+     * @param n_value The plain object to convert.
+     */
+    PyObject* ToPythonDict(const Napi::Env &n_env, const Napi::Value &n_value);
+
+    class DictShape;
+
+    /**
+     * Convert a dict into a plain object, or into a Map depending on its keys and the conversion
+     * options.
+     *
+     * @param n_env  The current Node environment.
+     * @param p_dict The dict to convert.
+     * @param shape  The shape of the previous dict of the same list, reused when the keys match.
+     */
+    Napi::Value ToNodeDict(const Napi::Env &n_env, PyObject *p_dict, DictShape &shape);
+
+    /**
+     * Convert a dict into a Map.
+     *
+     * @param n_env  The current Node environment.
+     * @param p_dict The dict to convert.
+     */
+    Napi::Value ToNodeMap(const Napi::Env &n_env, PyObject *p_dict);
 
     /**
      * Convert a PyLongObject into a Napi::BigInt.
@@ -39,6 +99,184 @@ namespace NPI
     PyObject* ToPythonLong(const Napi::Env &n_env, Napi::BigInt n_bigint);
 }
 
+namespace
+{
+    /**
+     * The nesting of the containers being converted into Node values on this thread.
+     */
+    thread_local size_t node_container_depth = 0;
+
+    /**
+     * Counts a container converted into a Node value for the duration of its conversion, which
+     * recurses on the native stack.
+     */
+    class NodeContainerScope
+    {
+        public:
+            explicit NodeContainerScope(const Napi::Env& n_env)
+            {
+                if (node_container_depth >= MAX_CONTAINER_DEPTH)
+                {
+                    throw Napi::RangeError::New(n_env, "The object is nested too deeply or contains a cycle.");
+                }
+
+                node_container_depth++;
+            }
+
+            ~NodeContainerScope() { node_container_depth--; }
+
+            NodeContainerScope(const NodeContainerScope&) = delete;
+
+            NodeContainerScope& operator=(const NodeContainerScope&) = delete;
+    };
+}
+
+/**
+ * The key set of a dict, along with the property descriptors that build an object of that shape in
+ * a single napi_define_properties call. Objects built from the same descriptors in the same order
+ * also share their hidden class in V8. Must be used while holding the GIL.
+ */
+class NPI::DictShape
+{
+    public:
+        DictShape() = default;
+
+        DictShape(const DictShape&) = delete;
+
+        DictShape& operator=(const DictShape&) = delete;
+
+        ~DictShape() { Reset(); }
+
+        /**
+         * Check whether a dict has exactly the keys of this shape, in the same order.
+         */
+        bool Matches(PyObject* p_dict) const
+        {
+            if (m_keys.empty() || (static_cast<size_t>(PyDict_GET_SIZE(p_dict)) != m_keys.size())) { return false; }
+
+            Py_ssize_t position = 0;
+            PyObject*  p_key;
+            PyObject*  p_value;
+
+            for (size_t i = 0; PyDict_Next(p_dict, &position, &p_key, &p_value); i++)
+            {
+                // Records decoded by the same parser usually share their key objects.
+                if ((p_key != m_keys[i]) && (!PyUnicode_CheckExact(p_key) || (PyUnicode_Compare(p_key, m_keys[i]) != 0)))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Take the shape of a dict.
+         *
+         * @return Whether every key of the dict is a string.
+         */
+        bool Assign(const Napi::Env& n_env, PyObject* p_dict)
+        {
+            Reset();
+
+            m_keys.reserve(PyDict_GET_SIZE(p_dict));
+            m_descriptors.reserve(PyDict_GET_SIZE(p_dict));
+
+            Py_ssize_t position = 0;
+            PyObject*  p_key;
+            PyObject*  p_value;
+
+            while (PyDict_Next(p_dict, &position, &p_key, &p_value))
+            {
+                if (!PyUnicode_Check(p_key))
+                {
+                    Reset();
+                    return false;
+                }
+
+                Py_ssize_t length;
+                auto key = PyUnicode_AsUTF8AndSize(p_key, &length);
+                if (key == NULL)
+                {
+                    Reset();
+                    NPI::ThrowPythonError(n_env);
+                }
+
+                Py_INCREF(p_key);
+                m_keys.push_back(p_key);
+
+                napi_property_descriptor descriptor = {};
+                descriptor.name       = Napi::String::New(n_env, key, length);
+                descriptor.attributes = static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+
+                m_descriptors.push_back(descriptor);
+            }
+
+            return true;
+        }
+
+        /**
+         * Build an object from a dict which matches this shape.
+         */
+        Napi::Value Build(const Napi::Env& n_env, PyObject* p_dict)
+        {
+            NodeContainerScope scope(n_env);
+
+            Py_ssize_t position = 0;
+            PyObject*  p_key;
+            PyObject*  p_value;
+
+            size_t i = 0;
+            for (; PyDict_Next(p_dict, &position, &p_key, &p_value); i++)
+            {
+                // Converting a value may run Python code, which can resize the dict.
+                if (i >= m_descriptors.size())
+                {
+                    throw Napi::Error::New(n_env, "The dict changed size during the conversion.");
+                }
+
+                Py_INCREF(p_value);
+                try
+                {
+                    m_descriptors[i].value = NPI::ToNodeValue(n_env, p_value);
+                }
+                catch (...)
+                {
+                    Py_DECREF(p_value);
+                    throw;
+                }
+
+                Py_DECREF(p_value);
+            }
+
+            if (i != m_descriptors.size())
+            {
+                throw Napi::Error::New(n_env, "The dict changed size during the conversion.");
+            }
+
+            auto n_object = Napi::Object::New(n_env);
+            if (napi_define_properties(n_env, n_object, m_descriptors.size(), m_descriptors.data()) != napi_ok)
+            {
+                throw Napi::Error::New(n_env, "Failed to define the properties of an object.");
+            }
+
+            return n_object;
+        }
+
+    private:
+        void Reset()
+        {
+            for (auto p_key : m_keys) { Py_DECREF(p_key); }
+
+            m_keys.clear();
+            m_descriptors.clear();
+        }
+
+        std::vector<PyObject*> m_keys;
+
+        std::vector<napi_property_descriptor> m_descriptors;
+};
+
 bool NPI::IsNullLike(const Napi::Value& payload)
 {
     return (payload.IsNull() || payload.IsUndefined());
@@ -76,6 +314,25 @@ Napi::Value NPI::ToNodeValue(const Napi::Env &n_env, PyObject *p_object)
     {
         return ToNodeArray(n_env, p_object);
     }
+    else if (PyDict_Check(p_object))
+    {
+        DictShape shape;
+        return ToNodeDict(n_env, p_object, shape);
+    }
+    else if (NPI_WrappedNodeObject_Check(p_object))
+    {
+        auto n_value = NPI_WrappedNodeObject_GetNodeValue(p_object);
+        if (n_value == NULL)
+        {
+            throw Napi::Error::New(n_env, "The wrapped Node value was already collected.");
+        }
+
+        return Napi::Value(n_env, n_value);
+    }
+    else if (GetInstanceData(n_env).arrow_output && IsArrowExportable(p_object))
+    {
+        return ToNodeArrow(n_env, p_object);
+    }
     else
     {
         // auto python_value_ref = Napi::External<PyObject>::New(node_env, python_value);
@@ -84,6 +341,32 @@ Napi::Value NPI::ToNodeValue(const Napi::Env &n_env, PyObject *p_object)
     }
 }
 
+Napi::Value NPI::ToNodeSharedBuffer(const Napi::Env& env, const void* data, size_t size, PyObject* p_owner, bool readonly)
+{
+    if ((data == nullptr) || (size == 0))
+    {
+        return Napi::ArrayBuffer::New(env, 0);
+    }
+
+    // ArrayBuffers are always writable, so read-only memory is only shared on request.
+    napi_value n_buffer;
+    auto status = (readonly && !GetInstanceData(env).share_readonly) ? napi_generic_failure : napi_create_external_arraybuffer(env, const_cast<void*>(data), size, [](napi_env, void*, void* hint)
+    {
+        ScheduleDecref(static_cast<PyObject*>(hint));
+    }, p_owner, &n_buffer);
+
+    if (status == napi_ok)
+    {
+        Py_INCREF(p_owner);
+        return Napi::Value(env, n_buffer);
+    }
+
+    auto n_copy = Napi::ArrayBuffer::New(env, size);
+    std::memcpy(n_copy.Data(), data, size);
+
+    return n_copy;
+}
+
 PyObject* NPI::ToPythonObject(const Napi::Value &n_value)
 {
     auto n_env = n_value.Env();
@@ -119,16 +402,243 @@ PyObject* NPI::ToPythonObject(const Napi::Value &n_value)
     {
         if (IsWrappedPythonObject(n_value.ToObject()))
         {
-            auto object = WrappedPythonObject::Unwrap(n_value.ToObject());
-            return object->Value();
+            auto object = WrappedPythonObject::Unwrap(n_value.ToObject())->Value();
+            Py_INCREF(object);
+
+            return object;
+        }
+        else if (IsHandle(n_value))
+        {
+            auto object = GetInstanceData(n_env).handles.Get(GetHandleId(n_value));
+            if (object == NULL)
+            {
+                throw Napi::Error::New(n_env, "The handle was already released.");
+            }
+
+            Py_INCREF(object);
+            return object;
+        }
+        else if (IsPlainObject(n_env, n_value))
+        {
+            return ToPythonDict(n_env, n_value);
+        }
+        else
+        {
+            return ToWrappedNodeObject(n_env, n_value);
+        }
+    }
+
+    throw Napi::TypeError::New(n_env, "The value cannot be converted into a Python object.");
+}
+
+namespace
+{
+    /**
+     * A container being filled by NPI::ToPythonDict. Dicts iterate over `n_keys`, lists over the
+     * elements of `n_source`.
+     */
+    struct ContainerFrame
+    {
+        PyObject*  p_container;
+        napi_value n_source;
+        napi_value n_keys;
+        uint32_t   length;
+        uint32_t   index;
+    };
+
+    bool IsContainer(const Napi::Env &n_env, const Napi::Value &n_value)
+    {
+        if (n_value.IsArray()) { return true; }
+
+        return n_value.IsObject()
+            && !n_value.IsFunction()
+            && !NPI::IsWrappedPythonObject(n_value.As<Napi::Object>())
+            && NPI::IsPlainObject(n_env, n_value);
+    }
+
+    /**
+     * Create an empty container for a plain object or an array, and push its frame.
+     *
+     * @return A new reference.
+     */
+    PyObject* NewContainer(const Napi::Env &n_env, const Napi::Value &n_value, std::vector<ContainerFrame> &stack)
+    {
+        ContainerFrame frame { NULL, n_value, nullptr, 0, 0 };
+
+        if (n_value.IsArray())
+        {
+            frame.length      = n_value.As<Napi::Array>().Length();
+            frame.p_container = PyList_New(frame.length);
         }
         else
         {
+            auto status = napi_get_all_property_names(n_env, n_value, napi_key_own_only,
+                static_cast<napi_key_filter>(napi_key_enumerable | napi_key_skip_symbols),
+                napi_key_numbers_to_strings, &frame.n_keys);
+            if (status != napi_ok)
+            {
+                throw Napi::Error::New(n_env, "Failed to enumerate the properties of an object.");
+            }
+
+            napi_get_array_length(n_env, frame.n_keys, &frame.length);
+            frame.p_container = _PyDict_NewPresized(frame.length);
+        }
 
+        if (frame.p_container == NULL)
+        {
+            NPI::ThrowPythonError(n_env);
         }
+
+        stack.push_back(frame);
+        return frame.p_container;
     }
+}
 
-    // throw Napi::Error::New
+bool NPI::IsPlainObject(const Napi::Env &n_env, const Napi::Value &n_value)
+{
+    napi_value n_prototype;
+    if (napi_get_prototype(n_env, n_value, &n_prototype) != napi_ok) { return false; }
+
+    auto prototype = Napi::Value(n_env, n_prototype);
+    return prototype.IsNull() || prototype.StrictEquals(GetInstanceData(n_env).object_prototype.Value());
+}
+
+PyObject* NPI::ToPythonDict(const Napi::Env &n_env, const Napi::Value &n_value)
+{
+    std::vector<ContainerFrame> stack;
+
+    auto p_root = NewContainer(n_env, n_value, stack);
+
+    try
+    {
+        while (!stack.empty())
+        {
+            auto& frame = stack.back();
+            if (frame.index == frame.length)
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            // The frame may be moved by the push of a nested container, take what is needed first.
+            auto i           = frame.index++;
+            auto p_container = frame.p_container;
+            auto n_keys      = frame.n_keys;
+
+            napi_value n_child;
+            PyObject*  p_key = NULL;
+
+            if (n_keys != nullptr)
+            {
+                // Getters and proxy traps may throw, which leaves the exception pending.
+                napi_value n_key;
+                if ((napi_get_element(n_env, n_keys, i, &n_key) != napi_ok)
+                    || (napi_get_property(n_env, frame.n_source, n_key, &n_child) != napi_ok))
+                {
+                    throw Napi::Error::New(n_env);
+                }
+
+                p_key = InternKey(n_env, n_key);
+                if (p_key == NULL)
+                {
+                    ThrowPythonError(n_env);
+                }
+            }
+            else if (napi_get_element(n_env, frame.n_source, i, &n_child) != napi_ok)
+            {
+                throw Napi::Error::New(n_env);
+            }
+
+            auto child = Napi::Value(n_env, n_child);
+
+            PyObject* p_child;
+            try
+            {
+                if (IsContainer(n_env, child))
+                {
+                    if (stack.size() >= MAX_CONTAINER_DEPTH)
+                    {
+                        throw Napi::RangeError::New(n_env, "The object is nested too deeply or contains a cycle.");
+                    }
+
+                    p_child = NewContainer(n_env, child, stack);
+                }
+                else
+                {
+                    p_child = ToPythonObject(child);
+                }
+            }
+            catch (...)
+            {
+                Py_XDECREF(p_key);
+                throw;
+            }
+
+            if (p_key != NULL)
+            {
+                auto status = PyDict_SetItem(p_container, p_key, p_child);
+                Py_DECREF(p_key);
+                Py_DECREF(p_child);
+
+                if (status < 0)
+                {
+                    ThrowPythonError(n_env);
+                }
+            }
+            else
+            {
+                PyList_SET_ITEM(p_container, i, p_child);
+            }
+        }
+    }
+    catch (...)
+    {
+        // Everything converted so far is owned by the root container.
+        Py_DECREF(p_root);
+        throw;
+    }
+
+    return p_root;
+}
+
+Napi::Value NPI::ToNodeResult(const Napi::Env &n_env, PyObject *p_object)
+{
+    auto& data = GetInstanceData(n_env);
+    if (data.handle_mode && (p_object != NULL) && (p_object != Py_None))
+    {
+        return ToNodeHandle(n_env, p_object);
+    }
+
+    return ToNodeValue(n_env, p_object);
+}
+
+Napi::Value NPI::ToNodeHandle(const Napi::Env &n_env, PyObject *p_object)
+{
+    auto n_handle = Napi::Object::New(n_env);
+    n_handle.Set("id", Napi::Number::New(n_env, GetInstanceData(n_env).handles.Acquire(p_object)));
+
+    // Frozen, so that the id of a handle cannot be swapped for the one of another object.
+    if ((napi_type_tag_object(n_env, n_handle, &handle_type_tag) != napi_ok) || (napi_object_freeze(n_env, n_handle) != napi_ok))
+    {
+        throw Napi::Error::New(n_env);
+    }
+
+    return n_handle;
+}
+
+bool NPI::IsHandle(const Napi::Value& n_value)
+{
+    if (!n_value.IsObject()) { return false; }
+
+    bool result = false;
+    napi_check_object_type_tag(n_value.Env(), n_value, &handle_type_tag, &result);
+
+    return result;
+}
+
+double NPI::GetHandleId(const Napi::Value& n_handle)
+{
+    return n_handle.As<Napi::Object>().Get("id").As<Napi::Number>().DoubleValue();
 }
 
 Napi::BigInt NPI::ToNodeBigInt(const Napi::Env &n_env, PyObject *p_long)
@@ -209,13 +719,30 @@ PyObject* NPI::ToPythonLong(const Napi::Env &n_env, Napi::BigInt n_bigint)
 
 Napi::Value NPI::ToNodeArray(const Napi::Env &n_env, PyObject *p_sequence)
 {
+    NodeContainerScope scope(n_env);
+
     auto length  = PySequence_Size(p_sequence);
     auto n_array = Napi::Array::New(n_env, length);
 
+    // Records in a list usually share their keys, so the shape of the previous dict is reused.
+    DictShape shape;
+
     for (Py_ssize_t i = 0; i < length; i++)
     {
         auto p_element = PySequence_GetItem(p_sequence, i);
-        auto n_element = ToNodeValue(n_env, p_element);
+
+        Napi::Value n_element;
+        try
+        {
+            n_element = PyDict_Check(p_element) ? ToNodeDict(n_env, p_element, shape) : ToNodeValue(n_env, p_element);
+        }
+        catch (...)
+        {
+            Py_DECREF(p_element);
+            throw;
+        }
+
+        Py_DECREF(p_element);
 
         n_array.Set(i, n_element);
     }
@@ -223,6 +750,46 @@ Napi::Value NPI::ToNodeArray(const Napi::Env &n_env, PyObject *p_sequence)
     return n_array;
 }
 
+Napi::Value NPI::ToNodeDict(const Napi::Env &n_env, PyObject *p_dict, DictShape &shape)
+{
+    auto map_output = GetInstanceData(n_env).map_output;
+
+    if (map_output != MapOutput::Always)
+    {
+        if (shape.Matches(p_dict) || shape.Assign(n_env, p_dict))
+        {
+            return shape.Build(n_env, p_dict);
+        }
+
+        if (map_output == MapOutput::Never)
+        {
+            return WrappedPythonObject::New(n_env, p_dict);
+        }
+    }
+
+    return ToNodeMap(n_env, p_dict);
+}
+
+Napi::Value NPI::ToNodeMap(const Napi::Env &n_env, PyObject *p_dict)
+{
+    NodeContainerScope scope(n_env);
+
+    auto& data  = GetInstanceData(n_env);
+    auto  n_map = data.map_constructor.New({});
+    auto  set   = data.map_set.Value();
+
+    Py_ssize_t position = 0;
+    PyObject*  p_key;
+    PyObject*  p_value;
+
+    while (PyDict_Next(p_dict, &position, &p_key, &p_value))
+    {
+        set.Call(n_map, { ToNodeValue(n_env, p_key), ToNodeValue(n_env, p_value) });
+    }
+
+    return n_map;
+}
+
 PyObject* NPI::ToPythonList(const Napi::Env &n_env, const Napi::Value &node_value)
 {
     auto node_array = node_value.As<Napi::Array>();
@@ -243,6 +810,35 @@ PyObject* NPI::ToPythonList(const Napi::Env &n_env, const Napi::Value &node_valu
     return python_list;
 }
 
+PyObject* NPI::ToWrappedNodeObject(const Napi::Env &n_env, const Napi::Value &n_value)
+{
+    auto& data     = GetInstanceData(n_env);
+    auto  wrappers = data.node_wrappers.Value();
+
+    auto n_cached = data.node_wrappers_get.Value().Call(wrappers, { n_value });
+    if (n_cached.IsExternal())
+    {
+        // A wrapper released on another thread stays cached until its environment disposes of it.
+        auto p_cached = n_cached.As<Napi::External<PyObject>>().Data();
+        if (Py_REFCNT(p_cached) > 0)
+        {
+            Py_INCREF(p_cached);
+
+            return p_cached;
+        }
+    }
+
+    auto p_wrapper = NPI_WrappedNodeObject_FromNode(n_env, n_value);
+    if (p_wrapper == NULL)
+    {
+        ThrowPythonError(n_env);
+    }
+
+    data.node_wrappers_set.Value().Call(wrappers, { n_value, Napi::External<PyObject>::New(n_env, p_wrapper) });
+
+    return p_wrapper;
+}
+
 bool NPI::IsSafeInteger(const Napi::Env& env, const Napi::Value& payload)
 {
     return env.Global()
@@ -257,6 +853,78 @@ bool NPI::IsSafeInteger(const Napi::Env& env, const Napi::Value& payload)
 
 bool NPI::IsWrappedPythonObject(const Napi::Object& payload)
 {
-    return payload.InstanceOf(WrappedPythonObject::Constructor().Value());
-    return false;
+    return WrappedPythonObject::IsInstance(payload);
+}
+
+Napi::Value NPI::MarkKeywordArguments(const Napi::Value& n_value)
+{
+    auto n_env = n_value.Env();
+
+    if (!IsPlainObject(n_env, n_value))
+    {
+        throw Napi::TypeError::New(n_env, "Keyword arguments must be a plain object.");
+    }
+
+    // An object can only be tagged once, so a marked object stays marked.
+    if (!IsKeywordArguments(n_value) && (napi_type_tag_object(n_env, n_value, &keyword_arguments_type_tag) != napi_ok))
+    {
+        throw Napi::Error::New(n_env);
+    }
+
+    return n_value;
+}
+
+bool NPI::IsKeywordArguments(const Napi::Value& n_value)
+{
+    if (!n_value.IsObject()) { return false; }
+
+    bool result = false;
+    napi_check_object_type_tag(n_value.Env(), n_value, &keyword_arguments_type_tag, &result);
+
+    return result;
+}
+
+napi_value NPI_PythonValueToNodeValue(napi_env node_env, PyObject* python_value)
+{
+    try
+    {
+        return NPI::ToNodeValue(node_env, python_value);
+    }
+    catch (const Napi::Error& error)
+    {
+        PyErr_SetString(PyExc_RuntimeError, error.Message().c_str());
+        return NULL;
+    }
+}
+
+PyObject* NPI_NodeValueToPythonValue(napi_env node_env, napi_value node_value)
+{
+    try
+    {
+        return NPI::ToPythonObject(Napi::Value(node_env, node_value));
+    }
+    catch (const Napi::Error& error)
+    {
+        PyErr_SetString(PyExc_RuntimeError, error.Message().c_str());
+        return NULL;
+    }
+}
+
+void NPI_ForgetWrappedNodeObject(napi_env node_env, napi_value node_value, PyObject* python_wrapper)
+{
+    try
+    {
+        auto& data     = NPI::GetInstanceData(node_env);
+        auto  wrappers = data.node_wrappers.Value();
+
+        auto n_cached = data.node_wrappers_get.Value().Call(wrappers, { node_value });
+        if (n_cached.IsExternal() && (n_cached.As<Napi::External<PyObject>>().Data() == python_wrapper))
+        {
+            data.node_wrappers_delete.Value().Call(wrappers, { node_value });
+        }
+    }
+    catch (const Napi::Error&)
+    {
+        // Releasing a wrapper cannot fail, a stale entry is replaced on the next lookup anyway.
+    }
 }
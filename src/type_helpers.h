@@ -13,6 +13,11 @@ napi_value NPI_PythonValueToNodeValue(napi_env node_env, PyObject* python_value)
 
 PyObject* NPI_NodeValueToPythonValue(napi_env node_env, napi_value node_value);
 
+/**
+ * Remove a `WrappedNodeObject` that is being released from the identity cache of its Node value.
+ */
+void NPI_ForgetWrappedNodeObject(napi_env node_env, napi_value node_value, PyObject* python_wrapper);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,10 +8,48 @@ namespace NPI
 {
     bool IsNullLike(const Napi::Value&);
 
+    bool IsWrappedPythonObject(const Napi::Object&);
+
+    /**
+     * Mark a plain object as the keyword arguments of a call, when passed as its last argument.
+     */
+    Napi::Value MarkKeywordArguments(const Napi::Value&);
+
+    bool IsKeywordArguments(const Napi::Value&);
+
     Napi::Value ToNodeValue(const Napi::Env&, PyObject*);
 
     Napi::Value ToNodeArray(const Napi::Env&, PyObject*);
 
+    /**
+     * Expose memory owned by a Python object as an ArrayBuffer without copying it. The buffer holds
+     * a reference to the owner until it is collected, and is copied on runtimes that refuse
+     * external memory. Read-only memory is copied too, unless the `shareReadOnly` conversion
+     * option is set.
+     */
+    Napi::Value ToNodeSharedBuffer(const Napi::Env&, const void* data, size_t size, PyObject* p_owner, bool readonly);
+
+    /**
+     * Convert the result of an operation, as a handle when the handle mode is enabled.
+     */
+    Napi::Value ToNodeResult(const Napi::Env&, PyObject*);
+
+    /**
+     * Store a Python object in the handle table of the environment, and return its handle: a
+     * frozen `{ id }` object tagged natively, so that it is never confused with a plain value.
+     * Handles are accepted wherever a Python object is.
+     */
+    Napi::Value ToNodeHandle(const Napi::Env&, PyObject*);
+
+    bool IsHandle(const Napi::Value&);
+
+    double GetHandleId(const Napi::Value&);
+
+    /**
+     * Convert a Node value into a Python object.
+     *
+     * @return A new reference.
+     */
     PyObject* ToPythonObject(const Napi::Value&);
 
     PyObject* ToPythonList(const Napi::Env&, const Napi::Value&);
@@ -0,0 +1,189 @@
+#include "watchdog.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    struct Watch
+    {
+        unsigned long thread_id;
+        NPI::Deadline deadline;
+        bool fired;
+    };
+
+    std::mutex watch_mutex;
+
+    std::condition_variable watch_changed;
+
+    std::unordered_map<uint64_t, Watch> watches;
+
+    uint64_t last_token = 0;
+
+    bool watchdog_started = false;
+
+    std::atomic<uint64_t> armed_total { 0 };
+    std::atomic<uint64_t> fired_total { 0 };
+
+    /**
+     * Wait for the earliest deadline and interrupt its thread. The watches are checked again once
+     * the GIL is held: a target disarms while holding the GIL, so a watch still armed then belongs
+     * to the code that is running.
+     */
+    void RunWatchdog()
+    {
+        std::unique_lock<std::mutex> lock(watch_mutex);
+
+        while (true)
+        {
+            auto now      = std::chrono::steady_clock::now();
+            auto earliest = NPI::Deadline::max();
+            auto expired  = false;
+
+            for (const auto& entry : watches)
+            {
+                if (entry.second.fired) { continue; }
+
+                expired  = expired || (entry.second.deadline <= now);
+                earliest = std::min(earliest, entry.second.deadline);
+            }
+
+            if (!expired)
+            {
+                if (earliest == NPI::Deadline::max())
+                {
+                    watch_changed.wait(lock);
+                }
+                else
+                {
+                    watch_changed.wait_until(lock, earliest);
+                }
+
+                continue;
+            }
+
+            lock.unlock();
+            auto gil_state = PyGILState_Ensure();
+            lock.lock();
+
+            now = std::chrono::steady_clock::now();
+            for (auto& entry : watches)
+            {
+                if (!entry.second.fired && (entry.second.deadline <= now))
+                {
+                    entry.second.fired = true;
+                    fired_total.fetch_add(1, std::memory_order_relaxed);
+
+                    PyThreadState_SetAsyncExc(entry.second.thread_id, PyExc_TimeoutError);
+                }
+            }
+
+            lock.unlock();
+            PyGILState_Release(gil_state);
+            lock.lock();
+        }
+    }
+}
+
+NPI::Deadline NPI::DeadlineAfter(double timeout_ms)
+{
+    auto timeout = std::chrono::duration<double, std::milli>(timeout_ms);
+
+    return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+}
+
+std::string NPI::DescribeTimeout(double timeout_ms)
+{
+    return "Interrupted after the timeout of " + std::to_string(static_cast<long long>(timeout_ms)) + " ms.";
+}
+
+uint64_t NPI::ArmWatchdog(Deadline deadline)
+{
+    std::lock_guard<std::mutex> lock(watch_mutex);
+
+    if (!watchdog_started)
+    {
+        // Lives as long as the process, like the interpreter it watches.
+        std::thread(RunWatchdog).detach();
+        watchdog_started = true;
+    }
+
+    auto token = ++last_token;
+    watches.emplace(token, Watch { PyThread_get_thread_ident(), deadline, false });
+    armed_total.fetch_add(1, std::memory_order_relaxed);
+    watch_changed.notify_one();
+
+    return token;
+}
+
+bool NPI::DisarmWatchdog(uint64_t token)
+{
+    std::lock_guard<std::mutex> lock(watch_mutex);
+
+    auto found = watches.find(token);
+    if (found == watches.end())
+    {
+        return false;
+    }
+
+    auto fired = found->second.fired;
+    if (fired)
+    {
+        PyThreadState_SetAsyncExc(found->second.thread_id, NULL);
+    }
+
+    watches.erase(found);
+
+    return fired;
+}
+
+NPI::WatchdogScope::WatchdogScope(double timeout_ms) : m_token(0), m_timeout_ms(timeout_ms), m_fired(false)
+{
+    if (timeout_ms >= 0)
+    {
+        m_token = ArmWatchdog(DeadlineAfter(timeout_ms));
+    }
+}
+
+bool NPI::WatchdogScope::Disarm()
+{
+    if (m_token != 0)
+    {
+        m_fired = DisarmWatchdog(m_token);
+        m_token = 0;
+    }
+
+    return m_fired;
+}
+
+double NPI::ParseTimeout(const Napi::Value& n_options)
+{
+    if (!n_options.IsObject())
+    {
+        return -1;
+    }
+
+    auto n_timeout = n_options.As<Napi::Object>().Get("timeoutMs");
+    if (!n_timeout.IsNumber())
+    {
+        return -1;
+    }
+
+    return std::max(0.0, n_timeout.As<Napi::Number>().DoubleValue());
+}
+
+NPI::WatchdogStats NPI::GetWatchdogStats()
+{
+    std::lock_guard<std::mutex> lock(watch_mutex);
+
+    return WatchdogStats
+    {
+        watches.size(),
+        armed_total.load(std::memory_order_relaxed),
+        fired_total.load(std::memory_order_relaxed),
+    };
+}
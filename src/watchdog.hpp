@@ -0,0 +1,93 @@
+#ifndef NPI_WATCHDOG_HPP
+#define NPI_WATCHDOG_HPP
+
+#include <napi.h>
+#include <Python.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace NPI
+{
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    /**
+     * A snapshot of the watchdog counters.
+     */
+    struct WatchdogStats
+    {
+        size_t   active;
+        uint64_t armed;
+        uint64_t fired;
+    };
+
+    /**
+     * The deadline `timeout_ms` from now.
+     */
+    Deadline DeadlineAfter(double timeout_ms);
+
+    /**
+     * The message of a `TimeoutError` raised by the watchdog.
+     */
+    std::string DescribeTimeout(double timeout_ms);
+
+    /**
+     * Interrupt the Python code of the current thread when it runs past a deadline, by raising a
+     * `TimeoutError` in its thread state from a watchdog thread. The interruption happens at the
+     * next bytecode boundary, so code blocked in C is only interrupted once it returns to Python.
+     *
+     * @return A token to disarm the deadline with.
+     */
+    uint64_t ArmWatchdog(Deadline deadline);
+
+    /**
+     * Disarm a deadline. A `TimeoutError` raised too late to interrupt anything is discarded, so
+     * that it cannot hit the next code run by the thread. The caller must hold the GIL.
+     *
+     * @return Whether the deadline was reached.
+     */
+    bool DisarmWatchdog(uint64_t token);
+
+    /**
+     * Arm the watchdog for a scope, when a timeout is given. Must be declared after the
+     * PythonEnsureGil of the scope, so that it is disarmed while the GIL is still held.
+     */
+    class WatchdogScope
+    {
+        public:
+            explicit WatchdogScope(double timeout_ms);
+
+            WatchdogScope(const WatchdogScope&) = delete;
+
+            WatchdogScope& operator=(const WatchdogScope&) = delete;
+
+            ~WatchdogScope() { Disarm(); }
+
+            /**
+             * @return Whether the deadline was reached.
+             */
+            bool Disarm();
+
+            double TimeoutMs() const { return m_timeout_ms; }
+
+        private:
+            uint64_t m_token;
+
+            double m_timeout_ms;
+
+            bool m_fired;
+    };
+
+    /**
+     * Read `timeoutMs` from an options object.
+     *
+     * @return The timeout, or a negative value when there is none.
+     */
+    double ParseTimeout(const Napi::Value& n_options);
+
+    WatchdogStats GetWatchdogStats();
+}
+
+#endif